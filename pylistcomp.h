@@ -6,14 +6,45 @@
 #include<algorithm>
 #include<initializer_list>
 #include<iterator>
+#include<vector>
+#include<atomic>
+#include<cstddef>
+#include<new>
+#include<limits>
+#include<optional>
+#include<tuple>
+#include<utility>
+#include<cstdint>
+#include<cstring>
+
+#ifndef LISTCOMP_DISABLE_MATH
+#include<cmath>
+#endif
+
+#ifndef LISTCOMP_DISABLE_GROUPING
+#include<unordered_map>
+#include<unordered_set>
+#include<stdexcept>
+#endif
 
 #ifndef LISTCOMP_DISABLE_STD_CONTAINERS
-#include<vector>
 #include<deque>
 #include<list>
 #include<forward_list>
 #endif
 
+#ifndef LISTCOMP_DISABLE_PIPELINE
+#include<thread>
+#include<memory>
+#include<exception>
+#include<mutex>
+#include<condition_variable>
+#endif
+
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L && !defined(LISTCOMP_DISABLE_CONCEPTS)
+#define LISTCOMP_USE_CONCEPTS
+#endif
+
 #ifndef LISTCOMP_DISABLE_OR_AND_NOT
 #define _or ||
 #define _and &&
@@ -24,28 +55,234 @@ namespace pylistcomp{
 
 class placeholder;
 template<auto> class trans;
+template<typename K, typename V, typename Hash = std::hash<K>> class memo_cache;
 
 namespace impl{
 
+template<typename Signature, std::size_t Capacity = 48>
+class small_function;
+
+template<typename R, typename... Args, std::size_t Capacity>
+class small_function<R(Args...), Capacity>{
+    private:
+        struct vtable{
+            R (*call)(void*, Args...);
+            void (*copy)(const void*, void*);
+            void (*move)(void*, void*);
+            void (*destroy)(void*);
+        };
+
+        template<typename F>
+        static constexpr bool is_local = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t)
+                                         && std::is_nothrow_move_constructible_v<F>;
+
+        template<typename F>
+        struct local_ops{
+            static R call(void* data, Args... args){
+                return (*static_cast<F*>(data))(std::forward<Args>(args)...);
+            }
+
+            static void copy(const void* src, void* dst){
+                new (dst) F(*static_cast<const F*>(src));
+            }
+
+            static void move(void* src, void* dst){
+                new (dst) F(std::move(*static_cast<F*>(src)));
+                static_cast<F*>(src)->~F();
+            }
+
+            static void destroy(void* data){
+                static_cast<F*>(data)->~F();
+            }
+
+            static constexpr vtable table{call, copy, move, destroy};
+        };
+
+        template<typename F>
+        struct heap_ops{
+            static F* get(const void* data){
+                return *static_cast<F* const*>(data);
+            }
+
+            static R call(void* data, Args... args){
+                return (*get(data))(std::forward<Args>(args)...);
+            }
+
+            static void copy(const void* src, void* dst){
+                new (dst) F*(new F(*get(src)));
+            }
+
+            static void move(void* src, void* dst){
+                new (dst) F*(get(src));
+            }
+
+            static void destroy(void* data){
+                delete get(data);
+            }
+
+            static constexpr vtable table{call, copy, move, destroy};
+        };
+
+        alignas(std::max_align_t) mutable unsigned char storage[Capacity];
+        const vtable* table = nullptr;
+
+    public:
+        small_function() = default;
+        small_function(std::nullptr_t) {};
+
+        template<typename F, typename=std::enable_if_t<!std::is_same_v<std::decay_t<F>, small_function>
+                                                       && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+        small_function(F&& func){
+            using Func = std::decay_t<F>;
+            if constexpr(std::is_pointer_v<Func>){
+                if(!func){
+                    return;
+                }
+            }
+            if constexpr(is_local<Func>){
+                new (storage) Func(std::forward<F>(func));
+                table = &local_ops<Func>::table;
+            }
+            else{
+                new (storage) Func*(new Func(std::forward<F>(func)));
+                table = &heap_ops<Func>::table;
+            }
+        }
+
+        small_function(const small_function& other) : table{other.table} {
+            if(table){
+                table->copy(other.storage, storage);
+            }
+        }
+
+        small_function(small_function&& other) noexcept : table{other.table} {
+            if(table){
+                table->move(other.storage, storage);
+                other.table = nullptr;
+            }
+        }
+
+        small_function &operator=(const small_function& other){
+            if(this != &other){
+                small_function copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        small_function &operator=(small_function&& other) noexcept {
+            if(this != &other){
+                reset();
+                if(other.table){
+                    other.table->move(other.storage, storage);
+                    table = other.table;
+                    other.table = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        ~small_function(){
+            reset();
+        }
+
+        void reset(){
+            if(table){
+                table->destroy(storage);
+                table = nullptr;
+            }
+        }
+
+        explicit operator bool() const {
+            return table != nullptr;
+        }
+
+        R operator()(Args... args) const {
+            return table->call(storage, std::forward<Args>(args)...);
+        }
+};
+
 template<typename T>
-using PredFunctor = std::function<bool(const T&)>;
+using PredFunctor = small_function<bool(const T&)>;
 
 template<typename InT, typename OutT>
-using ElseFunctor = std::function<OutT(InT)>;
+using ElseFunctor = small_function<OutT(InT)>;
 
 template <typename InT, typename OutT>
-using TransFunctor = std::function<OutT(InT)>;
+using TransFunctor = small_function<OutT(InT)>;
+
+inline std::size_t round_capacity(std::size_t capacity){
+    std::size_t res = 1;
+    while(res < capacity){
+        res <<= 1;
+    }
+    return res;
+}
 
 #define ADD_LIST_COMP_OPERATOR(TemplateClass,Typetag)\
 operator TemplateClass<Typetag> () {\
-    return TemplateClass<Typetag>(begin(), end());\
+    return TemplateClass<Typetag>(this->self().begin(), this->self().end());\
 }\
 \
 template<typename TT, typename=std::void_t<decltype(TT(std::declval<Typetag>()))>>\
 operator TemplateClass<TT> () {\
-    return TemplateClass<TT>(begin(), end());\
+    return TemplateClass<TT>(this->self().begin(), this->self().end());\
 }\
 
+#ifndef LISTCOMP_DISABLE_STD_CONTAINERS
+#define LISTCOMP_STD_CONVERTABLES std::vector,std::list,std::deque,std::forward_list
+#else
+#define LISTCOMP_STD_CONVERTABLES std::vector
+#endif
+
+#ifdef LISTCOMP_CONVERTABLES
+#define LISTCOMP_ALL_CONVERTABLES LISTCOMP_STD_CONVERTABLES,LISTCOMP_CONVERTABLES
+#else
+#define LISTCOMP_ALL_CONVERTABLES LISTCOMP_STD_CONVERTABLES
+#endif
+
+#ifdef LISTCOMP_USE_CONCEPTS
+template<template<typename...> typename, template<typename...> typename>
+struct is_same_template : std::false_type{
+};
+
+template<template<typename...> typename T>
+struct is_same_template<T,T> : std::true_type{
+};
+
+template<typename Derived, typename OutT, template<typename...> typename... Ts>
+struct convertable_oper{
+    protected:
+        Derived &self(){
+            return static_cast<Derived&>(*this);
+        }
+
+    public:
+        template<template<typename...> typename Cont, typename TT, typename... Rest>
+        requires (is_same_template<Cont,Ts>::value || ...) && requires { TT(std::declval<OutT>()); }
+        operator Cont<TT, Rest...> () {
+            return Cont<TT, Rest...>(self().begin(), self().end());
+        }
+};
+
+template<template<typename...> typename Cont, typename T>
+constexpr bool is_cont_v = requires { std::vector<T>(std::declval<Cont<T>>().begin(), std::declval<Cont<T>>().end()); };
+#else
+template<typename Derived, typename OutT, template<typename...> typename T>
+struct convertable_to{
+    protected:
+        Derived &self(){
+            return static_cast<Derived&>(*this);
+        }
+
+    public:
+        ADD_LIST_COMP_OPERATOR(T, OutT);
+};
+
+template<typename Derived, typename OutT, template<typename...> typename... Ts>
+struct convertable_oper : public convertable_to<Derived,OutT,Ts>... {
+};
+
 template<template<typename...> typename Cont, typename T, typename=void>
 struct is_cont_impl : std::false_type{
 };
@@ -57,10 +294,42 @@ struct is_cont_impl<Cont, T, std::void_t<decltype(std::vector<T>((std::declval<C
 
 template <template <typename...> typename Cont, typename T>
 constexpr bool is_cont_v = is_cont_impl<Cont, T>::value;
+#endif
+
+template<typename Derived, typename OutT>
+using convertable_t = convertable_oper<Derived, OutT, LISTCOMP_ALL_CONVERTABLES>;
 
 template <typename, typename, typename>
 class implicit_convertable;
 
+template<typename InT, typename OutT>
+struct stage_functors{
+    PredFunctor<InT> hasPred = nullptr;
+    ElseFunctor<InT,OutT> hasElse = nullptr;
+    TransFunctor<InT,OutT> hasTrans = nullptr;
+    PredFunctor<InT> hasStop = nullptr;
+};
+
+struct unbound_source{
+};
+
+#ifndef LISTCOMP_DISABLE_PIPELINE
+template <typename, typename, typename>
+class pipeline_impl;
+#endif
+
+template <typename>
+class buffer_impl;
+
+template <typename>
+class proxy_trans;
+
+template <typename>
+class proxy_bool;
+
+template <typename...>
+class zip_range;
+
 template<typename InT,typename OuT,typename=void>
 struct is_constructible : std::false_type{
 };
@@ -104,83 +373,43 @@ template<typename InT, typename OutT, typename Iterator>
 class iterator_underlying_t : public std::iterator<std::forward_iterator_tag, OutT>{
     private:
         void get_next(){
-            if (enclosing->hasPred && !(enclosing->hasElse)) {
-                PredFunctor<InT> predFunctor = enclosing->hasPred;
+            if (count >= enclosing->limit) {
+                iter = end;
+                return;
+            }
+            if (enclosing->functors().hasPred && !(enclosing->functors().hasElse)) {
+                const PredFunctor<InT> &predFunctor = enclosing->functors().hasPred;
                 while (iter != end && !predFunctor(*iter)){
                     iter++;
                 }
             }
+            if (enclosing->functors().hasStop && iter != end && !enclosing->functors().hasStop(*iter)) {
+                iter = end;
+            }
         }
 
     protected:
         Iterator iter;
         Iterator end;
         implicit_convertable<InT,OutT,Iterator> *enclosing;
+        std::size_t count;
 
     public:
         iterator_underlying_t &operator=(const iterator_underlying_t &other) = default;
         iterator_underlying_t(const iterator_underlying_t &other) = default;
-        iterator_underlying_t(const Iterator &_iter, const Iterator &_end, implicit_convertable<InT,OutT,Iterator>* _enclosing) : 
-        iter{_iter}, end{_end}, enclosing{_enclosing} {
+        iterator_underlying_t(const Iterator &_iter, const Iterator &_end, implicit_convertable<InT,OutT,Iterator>* _enclosing, std::size_t _count = 0) : 
+        iter{_iter}, end{_end}, enclosing{_enclosing}, count{_count} {
             get_next();
         };        
 
 };
 
-template<typename InT, typename OutT, typename Iterator, typename=void>
-class iterator_deref : public iterator_underlying_t<InT,OutT,Iterator> {
-    private:
-        OutT get_val(){
-            TransFunctor<InT,OutT> transFunctor = this->enclosing->hasTrans;
-            if(this->enclosing->hasElse){
-                PredFunctor<InT> predFunctor = this->enclosing->hasPred;
-                ElseFunctor<InT, OutT> elseFunctor = this->enclosing->hasElse;
-                return predFunctor(*(this->iter)) ? transFunctor(*(this->iter)) : elseFunctor(*(this->iter));
-            }
-            return transFunctor(*(this->iter));
-        }
-
-    public:
-        using iterator_underlying_t<InT, OutT,Iterator>::iterator_underlying_t;
-
-        auto operator*(){
-            return get_val();
-        }
-};
-
 template<typename InT, typename OutT, typename Iterator>
-class iterator_deref<InT, OutT, Iterator, std::enable_if_t<is_cons_or_same_v<InT,OutT>>> : public iterator_underlying_t<InT,OutT,Iterator> {  
+class iterator_deref : public iterator_underlying_t<InT,OutT,Iterator> {
     private:
         OutT get_val(){
-            if(!(this->enclosing->hasTrans) && !(this->enclosing->hasElse)){
-                return *(this->iter);
-            }
-            else if (this->enclosing->hasTrans && !(this->enclosing->hasElse)) {
-                TransFunctor<InT,OutT> transFunctor = this->enclosing->hasTrans;
-                return transFunctor(*(this->iter));
-            } 
-            else if(this->enclosing->hasTrans && this->enclosing->hasElse){
-                TransFunctor<InT,OutT> transFunctor = this->enclosing->hasTrans;
-                PredFunctor<InT> predFunctor = this->enclosing->hasPred;
-                ElseFunctor<InT,OutT> elseFunctor = this->enclosing->hasElse;
-                if(predFunctor(*(this->iter))){
-                    return transFunctor(*(this->iter));
-                } 
-                else {
-                    return elseFunctor(*(this->iter));
-                }
-            } 
-            else if(!(this->enclosing->hasTrans) && this->enclosing->hasElse){
-                PredFunctor<InT> predFunctor = this->enclosing->hasPred;
-                ElseFunctor<InT,OutT> elseFunctor = this->enclosing->hasElse;
-                if(predFunctor(*(this->iter))){
-                    return *(this->iter);
-                } 
-                else {
-                    return elseFunctor(*(this->iter));
-                }
-            }
-            return *(this->iter);
+            const stage_functors<InT,OutT> &stages = this->enclosing->functors();
+            return this->enclosing->produce(*(this->iter), !stages.hasElse || stages.hasPred(*(this->iter)));
         }
 
     public:
@@ -197,7 +426,7 @@ class iterator : public iterator_deref<InT,OutT,Iterator> {
         using iterator_deref<InT, OutT, Iterator>::iterator_deref;
 
         iterator &operator++(){
-            (*this) = iterator(++(this->iter), this->end, this->enclosing);
+            (*this) = iterator(++(this->iter), this->end, this->enclosing, this->count + 1);
             return *this;
         }
 
@@ -207,7 +436,7 @@ class iterator : public iterator_deref<InT,OutT,Iterator> {
             return res;
         }
         iterator &operator--(){
-            (*this) = iterator(--(this->iter), this->end, this->enclosing);
+            (*this) = iterator(--(this->iter), this->end, this->enclosing, this->count ? this->count - 1 : 0);
             return *this;
         }
 
@@ -227,56 +456,287 @@ class iterator : public iterator_deref<InT,OutT,Iterator> {
 };
 
 struct PredFlag{
-} pred_flag;
+};
 
 struct ElseFlag{
-} else_flag;
+};
 
 struct TransFlag{
-} trans_flag;
+};
 
-#ifdef LISTCOMP_CONVERTABLES
-template<typename InT, typename OutT, typename Iterator, template<typename...> typename... Ts>
-struct impl_oper : public impl_oper<InT,OutT,Iterator,Ts>... {
+inline constexpr PredFlag pred_flag{};
+inline constexpr ElseFlag else_flag{};
+inline constexpr TransFlag trans_flag{};
 
-};
+template<typename InT, typename OutT, typename Iterator>
+using impl_oper_t = std::conditional_t<std::is_same_v<Iterator,unbound_source>,
+                                       convertable_oper<implicit_convertable<InT,OutT,Iterator>, OutT>,
+                                       convertable_t<implicit_convertable<InT,OutT,Iterator>, OutT>>;
 
-template<typename InT, typename OutT, typename Iterator, template<typename...> typename T>
-struct impl_oper<InT,OutT,Iterator,T> {
-    virtual iterator<InT,OutT,Iterator> begin() = 0;
-    virtual iterator<InT,OutT,Iterator> end() = 0;
+template<typename T>
+constexpr bool is_radix_sortable_v = std::is_arithmetic_v<T> && !std::is_same_v<T,bool> && sizeof(T) <= sizeof(std::uint64_t);
 
-    ADD_LIST_COMP_OPERATOR(T, OutT);
-};
+template<typename T>
+std::uint64_t radix_key(const T& value){
+    if constexpr(std::is_floating_point_v<T>){
+        using Bits = std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+        static_assert(sizeof(T) == sizeof(Bits), "unsupported floating point width");
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        constexpr Bits signBit = Bits{1} << (sizeof(T) * 8 - 1);
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    }
+    else if constexpr(std::is_signed_v<T>){
+        constexpr std::uint64_t signBit = std::uint64_t{1} << (sizeof(T) * 8 - 1);
+        return static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<T>>(value)) ^ signBit;
+    }
+    else{
+        return static_cast<std::uint64_t>(value);
+    }
+}
+
+template<typename T>
+void radix_sort(std::vector<T>& values){
+    if(values.size() < 64){
+        std::sort(values.begin(), values.end());
+        return;
+    }
+    std::vector<T> scratch(values.size());
+    for(std::size_t shift = 0; shift < sizeof(T) * 8; shift += 8){
+        std::size_t counts[256] = {};
+        for(const T& value : values){
+            ++counts[(radix_key(value) >> shift) & 0xFF];
+        }
+        if(counts[(radix_key(values.front()) >> shift) & 0xFF] == values.size()){
+            continue;
+        }
+        std::size_t offset = 0;
+        for(std::size_t &count : counts){
+            const std::size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for(const T& value : values){
+            scratch[counts[(radix_key(value) >> shift) & 0xFF]++] = value;
+        }
+        values.swap(scratch);
+    }
+}
 
 template<typename InT, typename OutT, typename Iterator>
-class implicit_convertable : public impl_oper<InT, OutT, Iterator, LISTCOMP_CONVERTABLES>{
-#else
-template<typename InT, typename OutT, typename Iterator>
-class implicit_convertable{
-#endif
+class implicit_convertable : public impl_oper_t<InT, OutT, Iterator>{
     private:
         Iterator start;
         Iterator finish;
-        PredFunctor<InT> hasPred = nullptr;
-        ElseFunctor<InT,OutT> hasElse = nullptr;
-        TransFunctor<InT,OutT> hasTrans = nullptr;
+        stage_functors<InT,OutT> own;
+        const stage_functors<InT,OutT> *plan = nullptr;
+        std::size_t limit = std::numeric_limits<std::size_t>::max();
+
+        const stage_functors<InT,OutT> &functors() const {
+            return plan ? *plan : own;
+        }
+
+        void detach(){
+            if(plan){
+                own = *plan;
+                plan = nullptr;
+            }
+        }
+
+        implicit_convertable with_stop(PredFunctor<InT>&& stopFunc) const {
+            implicit_convertable res(*this);
+            res.detach();
+            if(res.own.hasStop){
+                res.own.hasStop = [earlier = std::move(res.own.hasStop), later = std::move(stopFunc)](const InT& arg) {
+                    return earlier(arg) && later(arg);
+                };
+            }
+            else{
+                res.own.hasStop = std::move(stopFunc);
+            }
+            return res;
+        }
+
+        OutT produce(const InT& value, bool matched) const {
+            if(!matched && functors().hasElse){
+                return functors().hasElse(value);
+            }
+            if constexpr(is_cons_or_same_v<InT,OutT>){
+                if(!functors().hasTrans){
+                    return OutT(value);
+                }
+            }
+            return functors().hasTrans(value);
+        }
 
+        std::vector<OutT> materialize(){
+            std::vector<OutT> values;
+            if constexpr(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>){
+                values.reserve(std::min<std::size_t>(limit, finish - start));
+            }
+            for(auto it = begin(), last = end(); it != last; ++it){
+                values.push_back(*it);
+            }
+            return values;
+        }
+
+        template<typename SourceIterator>
+        implicit_convertable<InT,OutT,SourceIterator> bind(SourceIterator first, SourceIterator last, bool owning) const {
+            static_assert(std::is_same_v<Iterator, unbound_source>, "only comprehensions built with _in<T>() can be applied to a source");
+            implicit_convertable<InT,OutT,SourceIterator> res(first, last, &functors(), limit);
+            if(owning){
+                res.detach();
+            }
+            return res;
+        }
+
+        template<typename Sink>
+        void route(Sink&& sink) const {
+            const stage_functors<InT,OutT> &stages = functors();
+            std::size_t count = 0;
+            for(Iterator it = start; it != finish && count < limit; ++it){
+                const InT &value = *it;
+                const bool matched = !stages.hasPred || stages.hasPred(value);
+                if(!matched && !stages.hasElse){
+                    sink(value, matched);
+                    continue;
+                }
+                if(stages.hasStop && !stages.hasStop(value)){
+                    break;
+                }
+                sink(value, matched);
+                ++count;
+            }
+        }
+
+#ifndef LISTCOMP_DISABLE_GROUPING
+        template<typename KeyF>
+        auto group_by_impl(const KeyF& keyF) const {
+            using Key = std::decay_t<decltype(keyF(std::declval<const InT&>()))>;
+            std::unordered_map<Key, std::vector<OutT>> groups;
+            route([&](const InT& value, bool matched) {
+                if(matched || functors().hasElse){
+                    groups[keyF(value)].push_back(produce(value, matched));
+                }
+            });
+            return groups;
+        }
+
+        template<typename KeyF>
+        std::vector<std::vector<OutT>> group_by_impl(const KeyF& keyF, std::size_t buckets) const {
+            using Key = std::decay_t<decltype(keyF(std::declval<const InT&>()))>;
+            static_assert(std::is_integral_v<Key>, "dense grouping needs integral keys");
+            std::vector<std::size_t> keys;
+            std::vector<OutT> values;
+            std::vector<std::size_t> counts(buckets, 0);
+            route([&](const InT& value, bool matched) {
+                if(!matched && !functors().hasElse){
+                    return;
+                }
+                const Key key = keyF(value);
+                if constexpr(std::is_signed_v<Key>){
+                    if(key < 0){
+                        throw std::out_of_range("_group_by key outside [0, buckets)");
+                    }
+                }
+                if(static_cast<std::size_t>(key) >= buckets){
+                    throw std::out_of_range("_group_by key outside [0, buckets)");
+                }
+                keys.push_back(static_cast<std::size_t>(key));
+                values.push_back(produce(value, matched));
+                ++counts[keys.back()];
+            });
+            std::vector<std::vector<OutT>> groups(buckets);
+            for(std::size_t bucket = 0; bucket < buckets; ++bucket){
+                groups[bucket].reserve(counts[bucket]);
+            }
+            for(std::size_t index = 0; index < values.size(); ++index){
+                groups[keys[index]].push_back(std::move(values[index]));
+            }
+            return groups;
+        }
+#endif
+
+        template<typename,typename,typename> friend class implicit_convertable;
         template<typename,typename,typename> friend class iterator_underlying_t;
-        template<typename,typename,typename,typename> friend class iterator_deref;
+        template<typename,typename,typename> friend class iterator_deref;
+#ifndef LISTCOMP_DISABLE_PIPELINE
+        template<typename,typename,typename> friend class pipeline_impl;
+#endif
+
+    protected:
+        template<typename Hash>
+        void memoize(memo_cache<InT,OutT,Hash>& cache){
+            if(own.hasTrans){
+                own.hasTrans = [transFunctor = std::move(own.hasTrans), cache = &cache](const InT& arg) {
+                    return cache->lookup(arg, transFunctor);
+                };
+            }
+        }
 
     public:
-        implicit_convertable(implicit_convertable&& other, PredFunctor<InT>&& predFunc, PredFlag&) : 
-            start{other.start}, finish{other.finish}, hasTrans{other.hasTrans}, hasPred{predFunc} {};
+        implicit_convertable(implicit_convertable&& other, PredFunctor<InT>&& predFunc, PredFlag) : 
+            start{other.start}, finish{other.finish}, own{std::move(other.own)}, limit{other.limit} {
+            own.hasPred = std::move(predFunc);
+        };
         
-        implicit_convertable(implicit_convertable&& other, ElseFunctor<InT,OutT>&& elseFunc, ElseFlag&) : 
-            start{other.start}, finish{other.finish}, hasTrans{other.hasTrans}, hasPred{other.hasPred}, hasElse{elseFunc} {};
+        implicit_convertable(implicit_convertable&& other, ElseFunctor<InT,OutT>&& elseFunc, ElseFlag) : 
+            start{other.start}, finish{other.finish}, own{std::move(other.own)}, limit{other.limit} {
+            own.hasElse = std::move(elseFunc);
+        };
 
         template <typename TT>
         implicit_convertable(const TT &begin, const TT &end) : start{begin}, finish{end} {};
 
         template <typename TT>
-        implicit_convertable(const TT &begin, const TT &end, TransFunctor<InT,OutT>&& trans) : start{begin}, finish{end}, hasTrans{trans} {};
+        implicit_convertable(const TT &begin, const TT &end, TransFunctor<InT,OutT>&& trans) : start{begin}, finish{end} {
+            own.hasTrans = std::move(trans);
+        };
+
+        implicit_convertable(const Iterator &begin, const Iterator &end, const stage_functors<InT,OutT> *_plan, std::size_t _limit) :
+            start{begin}, finish{end}, plan{_plan}, limit{_limit} {};
+
+        template <template<typename> typename Cont, typename T>
+        auto operator()(const Cont<T> &container) const & {
+            static_assert(is_cont_v<Cont,T>, "argument is not a container type");
+            return bind(container.begin(), container.end(), false);
+        }
+
+        template <template<typename> typename Cont, typename T>
+        auto operator()(const Cont<T> &container) const && {
+            static_assert(is_cont_v<Cont,T>, "argument is not a container type");
+            return bind(container.begin(), container.end(), true);
+        }
+
+        template <typename T>
+        auto operator()(const std::initializer_list<T> &container) const & {
+            return bind(std::begin(container), std::end(container), false);
+        }
+
+        template <typename T>
+        auto operator()(const std::initializer_list<T> &container) const && {
+            return bind(std::begin(container), std::end(container), true);
+        }
+
+        template<typename T, size_t Size>
+        auto operator()(const T(&array)[Size]) const & {
+            return bind(std::begin(array), std::end(array), false);
+        }
+
+        template<typename T, size_t Size>
+        auto operator()(const T(&array)[Size]) const && {
+            return bind(std::begin(array), std::end(array), true);
+        }
+
+        template<typename... Iterators>
+        auto operator()(const zip_range<Iterators...> &source) const & {
+            return bind(source.begin(), source.end(), false);
+        }
+
+        template<typename... Iterators>
+        auto operator()(const zip_range<Iterators...> &source) const && {
+            return bind(source.begin(), source.end(), true);
+        }
 
         iterator<InT,OutT,Iterator> begin() {
             return iterator<InT,OutT,Iterator>(start,finish,this);
@@ -286,225 +746,750 @@ class implicit_convertable{
             return iterator<InT,OutT,Iterator>(finish,finish,this);
         }
 
-#ifndef LISTCOMP_DISABLE_STD_CONTAINERS
-        ADD_LIST_COMP_OPERATOR(std::vector, OutT);
+        implicit_convertable _take(std::size_t n) const {
+            implicit_convertable res(*this);
+            res.limit = std::min(limit, n);
+            return res;
+        }
+
+        template<typename E>
+        implicit_convertable _take_while(const proxy_bool<E>& proxy) const {
+            return with_stop([expr = proxy.get_pred()](const InT& arg) ->bool { return expr(arg); });
+        }
 
-        ADD_LIST_COMP_OPERATOR(std::list, OutT);
+        template<typename E>
+        implicit_convertable _take_while(const proxy_trans<E>& proxy) const {
+            return with_stop([expr = proxy.get_expr()](const InT& arg) ->bool { return expr(arg); });
+        }
 
-        ADD_LIST_COMP_OPERATOR(std::deque, OutT);
+        implicit_convertable _take_while(PredFunctor<InT> stopF) const {
+            return with_stop(std::move(stopF));
+        }
 
-        ADD_LIST_COMP_OPERATOR(std::forward_list, OutT);
+        std::optional<OutT> _first(){
+            auto first = begin();
+            if(first != end()){
+                return *first;
+            }
+            return std::nullopt;
+        }
+
+        template<typename Compare = std::less<>>
+        buffer_impl<OutT> _top_k(std::size_t k, Compare cmp = Compare{}){
+            std::vector<OutT> heap;
+            if(k == 0){
+                return buffer_impl<OutT>(std::move(heap));
+            }
+            if constexpr(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>){
+                heap.reserve(std::min<std::size_t>(k, finish - start));
+            }
+            auto after = [&cmp](const OutT& lhs, const OutT& rhs) { return cmp(rhs, lhs); };
+            for(auto it = begin(), last = end(); it != last; ++it){
+                if(heap.size() < k){
+                    heap.push_back(*it);
+                    std::push_heap(heap.begin(), heap.end(), after);
+                }
+                else{
+                    OutT value = *it;
+                    if(cmp(heap.front(), value)){
+                        std::pop_heap(heap.begin(), heap.end(), after);
+                        heap.back() = std::move(value);
+                        std::push_heap(heap.begin(), heap.end(), after);
+                    }
+                }
+            }
+            std::sort_heap(heap.begin(), heap.end(), after);
+            return buffer_impl<OutT>(std::move(heap));
+        }
+
+#ifndef LISTCOMP_DISABLE_GROUPING
+        buffer_impl<OutT> _distinct(){
+            std::unordered_set<OutT> seen;
+            std::vector<OutT> values;
+            for(auto it = begin(), last = end(); it != last; ++it){
+                OutT value = *it;
+                if(seen.insert(value).second){
+                    values.push_back(std::move(value));
+                }
+            }
+            return buffer_impl<OutT>(std::move(values));
+        }
+#endif
+
+        buffer_impl<OutT> _sorted(){
+            std::vector<OutT> values = materialize();
+            if constexpr(is_radix_sortable_v<OutT>){
+                radix_sort(values);
+            }
+            else{
+                std::sort(values.begin(), values.end());
+            }
+            return buffer_impl<OutT>(std::move(values));
+        }
+
+        template<typename Compare>
+        buffer_impl<OutT> _sorted(Compare cmp){
+            std::vector<OutT> values = materialize();
+            std::sort(values.begin(), values.end(), cmp);
+            return buffer_impl<OutT>(std::move(values));
+        }
+
+        buffer_impl<OutT> _sorted_distinct(){
+            std::vector<OutT> values = materialize();
+            if constexpr(is_radix_sortable_v<OutT>){
+                radix_sort(values);
+            }
+            else{
+                std::sort(values.begin(), values.end());
+            }
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+            return buffer_impl<OutT>(std::move(values));
+        }
+
+        std::pair<buffer_impl<OutT>, buffer_impl<OutT>> _partition() const {
+            std::vector<OutT> matching;
+            std::vector<OutT> rest;
+            route([&](const InT& value, bool matched) {
+                (matched ? matching : rest).push_back(produce(value, matched));
+            });
+            return {buffer_impl<OutT>(std::move(matching)), buffer_impl<OutT>(std::move(rest))};
+        }
+
+#ifndef LISTCOMP_DISABLE_GROUPING
+        template<typename E>
+        auto _group_by(const proxy_trans<E>& proxy) const {
+            return group_by_impl(proxy.get_expr());
+        }
+
+        template<typename E>
+        auto _group_by(const proxy_trans<E>& proxy, std::size_t buckets) const {
+            return group_by_impl(proxy.get_expr(), buckets);
+        }
+
+        template<typename KeyF, typename = std::enable_if_t<std::is_invocable_v<const KeyF&, const InT&>>>
+        auto _group_by(KeyF keyF) const {
+            return group_by_impl(keyF);
+        }
+
+        template<typename KeyF, typename = std::enable_if_t<std::is_invocable_v<const KeyF&, const InT&>>>
+        auto _group_by(KeyF keyF, std::size_t buckets) const {
+            return group_by_impl(keyF, buckets);
+        }
+#endif
+
+#ifndef LISTCOMP_DISABLE_PIPELINE
+        pipeline_impl<InT,OutT,Iterator> _pipelined(std::size_t capacity = 1024) const {
+            return pipeline_impl<InT,OutT,Iterator>(*this, capacity);
+        }
 #endif
 };
 
-template<typename InT, typename OutT, typename Iterator>
-class else_impl : public implicit_convertable<InT,OutT,Iterator>{
+template<typename OutT>
+class buffer_impl : public convertable_t<buffer_impl<OutT>, OutT>{
+    private:
+        std::vector<OutT> values;
+
     public:
-        using implicit_convertable<InT,OutT,Iterator>::implicit_convertable;
-};
+        buffer_impl(std::vector<OutT>&& _values) : values{std::move(_values)} {};
+
+        typename std::vector<OutT>::iterator begin() {
+            return values.begin();
+        }
 
-enum class oper_flag{
-    mult,div,add,sub,mod,rmult,rdiv,radd,rsub,rmod
+        typename std::vector<OutT>::iterator end() {
+            return values.end();
+        }
 };
 
-template<typename InT>
-class proxy_trans{
+#ifndef LISTCOMP_DISABLE_PIPELINE
+template<typename T>
+class spsc_queue{
     private:
-        ElseFunctor<InT,InT> elseFunc;
+        using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+        static constexpr int spin_limit = 64;
+
+        std::size_t mask;
+        std::unique_ptr<Storage[]> buffer;
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+        alignas(64) std::atomic<bool> closed{false};
+        std::atomic<int> sleepers{0};
+        std::mutex lock;
+        std::condition_variable wakeup;
+
+        template<typename Ready>
+        void park(const Ready& ready){
+            for(int spin = 0; spin < spin_limit; ++spin){
+                if(ready()){
+                    return;
+                }
+                std::this_thread::yield();
+            }
+            std::unique_lock<std::mutex> guard(lock);
+            sleepers.fetch_add(1);
+            wakeup.wait(guard, ready);
+            sleepers.fetch_sub(1);
+        }
+
+    public:
+        explicit spsc_queue(std::size_t capacity) : mask{round_capacity(capacity) - 1}, buffer{new Storage[mask + 1]} {};
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue &operator=(const spsc_queue&) = delete;
+
+        ~spsc_queue(){
+            while(try_pop()){
+            }
+        }
 
-        template<typename TT> friend class proxy_trans;
+        bool push(T&& value, const std::atomic<bool>& cancelled){
+            const std::size_t pos = tail.load(std::memory_order_relaxed);
+            if(pos - head.load(std::memory_order_acquire) > mask){
+                park([&] { return pos - head.load() <= mask / 2 || cancelled.load(); });
+                if(pos - head.load() > mask){
+                    return false;
+                }
+            }
+            new (&buffer[pos & mask]) T(std::move(value));
+            tail.store(pos + 1);
+            notify();
+            return true;
+        }
+
+        std::optional<T> try_pop(){
+            const std::size_t pos = head.load(std::memory_order_relaxed);
+            if(pos == tail.load(std::memory_order_acquire)){
+                return std::nullopt;
+            }
+            T *item = std::launder(reinterpret_cast<T*>(&buffer[pos & mask]));
+            std::optional<T> res{std::move(*item)};
+            item->~T();
+            head.store(pos + 1);
+            if(tail.load() - (pos + 1) <= mask / 2){
+                notify();
+            }
+            return res;
+        }
+
+        std::optional<T> pop(const std::atomic<bool>& cancelled){
+            if(auto res = try_pop()){
+                return res;
+            }
+            const std::size_t pos = head.load(std::memory_order_relaxed);
+            park([&] { return pos != tail.load() || closed.load() || cancelled.load(); });
+            if(pos == tail.load() || cancelled.load()){
+                return std::nullopt;
+            }
+            return try_pop();
+        }
+
+        void close(){
+            closed.store(true);
+            notify();
+        }
+
+        void notify(){
+            if(sleepers.load() > 0){
+                std::lock_guard<std::mutex> guard(lock);
+                wakeup.notify_all();
+            }
+        }
+};
+
+template<typename Cancel>
+class stage_thread{
+    private:
+        const Cancel &cancel;
+        std::thread worker;
 
     public:
-        auto get_else() const {
-            return elseFunc;
+        template<typename F>
+        stage_thread(const Cancel &_cancel, F&& body) : cancel{_cancel}, worker{std::forward<F>(body)} {};
+        stage_thread(const stage_thread&) = delete;
+        stage_thread &operator=(const stage_thread&) = delete;
+
+        ~stage_thread(){
+            if(worker.joinable()){
+                cancel();
+                worker.join();
+            }
         }
 
-        proxy_trans(ElseFunctor<InT, InT> _elseFunc) : elseFunc{_elseFunc} {};
+        void join(){
+            worker.join();
+        }
+};
 
-        proxy_trans(oper_flag flag, const InT& value){
-            switch(flag){
-                case oper_flag::mult:
-                    elseFunc = [&](const auto& arg) { return arg * value; };
-                    break;
-                case oper_flag::div:
-                    elseFunc = [&](const auto& arg) { return arg / value; };
-                    break;
-                case oper_flag::add:
-                    elseFunc = [&](const auto& arg) { return arg + value; };
-                    break;
-                case oper_flag::sub:
-                    elseFunc = [&](const auto& arg) { return arg - value; };
-                    break;
-                case oper_flag::mod:
-                    elseFunc = [&](const auto& arg) { return arg % value; };
-                    break;
-                case oper_flag::rmult:
-                    elseFunc = [&](const auto& arg) { return value * arg; };
-                    break;
-                case oper_flag::rdiv:
-                    elseFunc = [&](const auto& arg) { return value / arg; };
-                    break;
-                case oper_flag::radd:
-                    elseFunc = [&](const auto& arg) { return value + arg; };
-                    break;
-                case oper_flag::rsub:
-                    elseFunc = [&](const auto& arg) { return value - arg; };
-                    break;
-                case oper_flag::rmod:
-                    elseFunc = [&](const auto& arg) { return value % arg; };
+template<typename InT, typename OutT, typename Iterator>
+class pipeline_impl : public convertable_t<pipeline_impl<InT,OutT,Iterator>, OutT>{
+    private:
+        implicit_convertable<InT,OutT,Iterator> stages;
+        std::size_t capacity;
+        std::vector<OutT> results;
+        bool evaluated = false;
+
+        void run(){
+            spsc_queue<InT> read_queue(capacity);
+            spsc_queue<std::pair<InT,bool>> filter_queue(capacity);
+            std::atomic<bool> cancelled{false};
+            std::exception_ptr read_error, filter_error;
+            auto cancel = [&] {
+                cancelled.store(true);
+                read_queue.notify();
+                filter_queue.notify();
+            };
+
+            stage_thread reader(cancel, [&] {
+                try{
+                    for(Iterator it = stages.start; it != stages.finish && !cancelled.load(std::memory_order_relaxed); ++it){
+                        if(!read_queue.push(InT(*it), cancelled)){
+                            break;
+                        }
+                    }
+                }
+                catch(...){
+                    read_error = std::current_exception();
+                    cancel();
+                }
+                read_queue.close();
+            });
+
+            stage_thread filter(cancel, [&] {
+                try{
+                    while(auto value = read_queue.pop(cancelled)){
+                        const bool keep = !stages.functors().hasPred || stages.functors().hasPred(*value);
+                        if(!keep && !stages.functors().hasElse){
+                            continue;
+                        }
+                        if(stages.functors().hasStop && !stages.functors().hasStop(*value)){
+                            break;
+                        }
+                        if(!filter_queue.push(std::pair<InT,bool>(std::move(*value), keep), cancelled)){
+                            break;
+                        }
+                    }
+                }
+                catch(...){
+                    filter_error = std::current_exception();
+                    cancel();
+                }
+                filter_queue.close();
+            });
+
+            results.clear();
+            while(results.size() < stages.limit){
+                auto item = filter_queue.pop(cancelled);
+                if(!item){
                     break;
+                }
+                results.push_back(stages.produce(item->first, item->second));
             }
-        } 
+            cancel();
+            reader.join();
+            filter.join();
+
+            if(read_error){
+                std::rethrow_exception(read_error);
+            }
+            if(filter_error){
+                std::rethrow_exception(filter_error);
+            }
+            evaluated = true;
+        }
+
+    public:
+        pipeline_impl(const implicit_convertable<InT,OutT,Iterator>& comp, std::size_t _capacity) :
+            stages{comp}, capacity{_capacity} {};
+
+        typename std::vector<OutT>::iterator begin() {
+            if(!evaluated){
+                run();
+            }
+            return results.begin();
+        }
+
+        typename std::vector<OutT>::iterator end() {
+            if(!evaluated){
+                run();
+            }
+            return results.end();
+        }
 };
+#endif
 
 template<typename InT, typename OutT, typename Iterator>
-class if_impl : public implicit_convertable<InT,OutT,Iterator>{
+class else_impl : public implicit_convertable<InT,OutT,Iterator>{
     public:
         using implicit_convertable<InT,OutT,Iterator>::implicit_convertable;
+};
 
-        template<auto F>
-        else_impl<InT,OutT,Iterator> _else(trans<F>&&){
-            static_assert(is_cons_or_same_v<typename function_ptr<decltype(F)>::ReturnType,OutT>);
-            ElseFunctor<InT, OutT> elseFunctor = F;
-            return else_impl<InT, OutT, Iterator>(std::move(*this), std::move(elseFunctor),else_flag);
-        }
+struct arg_expr{
+    template<typename T>
+    const T& operator()(const T& arg) const {
+        return arg;
+    }
+};
 
-        else_impl<InT,OutT,Iterator> _else(placeholder&){
-            ElseFunctor<InT,OutT> elseFunctor = [&](const auto &arg) { return arg; };
-            return else_impl<InT,OutT,Iterator>(std::move(*this), std::move(elseFunctor),else_flag);
-        }
+template<typename T>
+struct value_expr{
+    T value;
 
-        else_impl<InT,OutT,Iterator> _else(const OutT& val){
-            ElseFunctor<InT,OutT> elseFunctor = [&] (const auto& arg) { return val; };
-            return else_impl<InT,OutT,Iterator>(std::move(*this), std::move(elseFunctor),else_flag);
-        }
+    template<typename TT>
+    const T& operator()(const TT&) const {
+        return value;
+    }
+};
+
+template<typename Op, typename E>
+struct unary_expr{
+    E expr;
+
+    template<typename T>
+    auto operator()(const T& arg) const {
+        return Op{}(expr(arg));
+    }
+};
+
+template<typename Op, typename L, typename R>
+struct binary_expr{
+    L lhs;
+    R rhs;
+
+    template<typename T>
+    auto operator()(const T& arg) const {
+        return Op{}(lhs(arg), rhs(arg));
+    }
+};
+
+template<typename L, typename R>
+struct and_expr{
+    L lhs;
+    R rhs;
+
+    template<typename T>
+    bool operator()(const T& arg) const {
+        return lhs(arg) && rhs(arg);
+    }
+};
+
+template<typename L, typename R>
+struct or_expr{
+    L lhs;
+    R rhs;
+
+    template<typename T>
+    bool operator()(const T& arg) const {
+        return lhs(arg) || rhs(arg);
+    }
+};
+
+template<typename Iterator>
+struct contains_expr{
+    Iterator first;
+    Iterator last;
+
+    template<typename T>
+    bool operator()(const T& arg) const {
+        return std::find(first, last, arg) != last;
+    }
+};
+
+template<typename T>
+struct list_contains_expr{
+    std::vector<T> values;
+
+    template<typename TT>
+    bool operator()(const TT& arg) const {
+        return std::find(values.begin(), values.end(), arg) != values.end();
+    }
+};
+
+template<typename Cont>
+struct owned_contains_expr{
+    Cont values;
 
-        else_impl<InT,OutT,Iterator> _else(proxy_trans<InT>&& proxy){
-            return else_impl<InT,OutT,Iterator>(std::move(*this), proxy.get_else(),else_flag);
+    template<typename T>
+    bool operator()(const T& arg) const {
+        return std::find(values.begin(), values.end(), arg) != values.end();
+    }
+};
+
+template<auto F, typename E>
+struct call_expr{
+    E expr;
+
+    template<typename T>
+    auto operator()(const T& arg) const {
+        return F(expr(arg));
+    }
+};
+
+template<std::size_t N, typename E>
+struct get_expr{
+    E expr;
+
+    template<typename T>
+    decltype(auto) operator()(const T& arg) const {
+        if constexpr(std::is_lvalue_reference_v<decltype(expr(arg))>){
+            return std::get<N>(expr(arg));
         }
+        else{
+            return std::decay_t<decltype(std::get<N>(expr(arg)))>(std::get<N>(expr(arg)));
+        }
+    }
+};
 
-        else_impl<InT,OutT,Iterator> _else(ElseFunctor<InT,OutT> elseFunctor){
-            return else_impl<InT,OutT,Iterator>(std::move(*this), std::move(elseFunctor), else_flag);
+#ifndef LISTCOMP_DISABLE_MATH
+struct abs_op{
+    template<typename T>
+    auto operator()(const T& value) const {
+        if constexpr(std::is_unsigned_v<T>){
+            return value;
+        }
+        else{
+            using std::abs;
+            return abs(value);
         }
+    }
 };
 
-enum class bool_flag{
-    equals, nequals, lthan, gthan, lthaneq, gthaneq, requals, rnequals, rlthan, rgthan, rlthaneq, rgthaneq
+struct sqrt_op{
+    template<typename T>
+    auto operator()(const T& value) const {
+        using std::sqrt;
+        return sqrt(value);
+    }
 };
 
-template<typename T>
+struct pow_op{
+    template<typename T, typename TT>
+    auto operator()(const T& base, const TT& exponent) const {
+        using std::pow;
+        return pow(base, exponent);
+    }
+};
+#endif
+
+template<typename> class for_expr_impl;
+
+template<typename E>
+class proxy_trans{
+    private:
+        E expr;
+
+    public:
+        proxy_trans(E _expr) : expr{std::move(_expr)} {};
+
+        const E& get_expr() const {
+            return expr;
+        }
+
+        for_expr_impl<E> _for(placeholder&) const {
+            return for_expr_impl<E>{expr};
+        }
+};
+
+template<typename E>
 class proxy_bool{
     private:
-        proxy_bool() = delete;
-        PredFunctor<T> predFunc;
+        E pred;
+
+    public:
+        proxy_bool(E _pred) : pred{std::move(_pred)} {};
 
-        template<typename TT> friend class proxy_bool;
+        const E& get_pred() const {
+            return pred;
+        }
+};
+
+template<typename Op, typename T>
+using not_cmp_expr = unary_expr<std::logical_not<>, binary_expr<Op, arg_expr, value_expr<std::decay_t<T>>>>;
+
+class not_proxy_bool{
+    private:
+        template<typename Op, typename T>
+        static proxy_bool<not_cmp_expr<Op,T>> negate(T&& value){
+            return not_cmp_expr<Op,T>{{arg_expr{}, value_expr<std::decay_t<T>>{std::forward<T>(value)}}};
+        }
 
     public:
-        auto get_pred() const {
-            return predFunc;
+        not_proxy_bool() = default;
+
+        template<typename T>
+        proxy_bool<not_cmp_expr<std::equal_to<>,T>> operator==(T&& value) const {
+            return negate<std::equal_to<>>(std::forward<T>(value));
         }
 
-        proxy_bool(bool_flag flag, const T& value, bool negative=false){
-            switch(flag){
-                case bool_flag::equals:
-                    predFunc = [&,negative](auto arg) { return negative ? !(arg==value) : arg == value; };
-                    break;
-                case bool_flag::nequals:
-                    predFunc = [&,negative](auto arg) { return negative ? !(arg!=value) : arg != value; };
-                    break;
-                case bool_flag::lthan:
-                    predFunc = [&,negative](auto arg) { return negative ? !(arg<value) : arg < value; };
-                    break;
-                case bool_flag::gthan:
-                    predFunc = [&,negative](auto arg) { return negative ? !(arg>value) : arg > value; };
-                    break;
-                case bool_flag::lthaneq:
-                    predFunc = [&,negative](auto arg) { return negative ? !(arg<=value) : arg <= value; };
-                    break;
-                case bool_flag::gthaneq:
-                    predFunc = [&,negative](auto arg) { return negative ? !(arg>=value) : arg >= value; };
-                    break;
-                case bool_flag::requals:
-                    predFunc = [&](auto arg) { return value == arg; };
-                    break;
-                case bool_flag::rnequals:
-                    predFunc = [&](auto arg) { return value != arg; };
-                    break;
-                case bool_flag::rlthan:
-                    predFunc = [&](auto arg) { return value < arg; };
-                    break;
-                case bool_flag::rgthan:
-                    predFunc = [&](auto arg) { return value > arg; };
-                    break;
-                case bool_flag::rlthaneq:
-                    predFunc = [&](auto arg) { return value <= arg; };
-                    break;
-                case bool_flag::rgthaneq:
-                    predFunc = [&](auto arg) { return value >= arg; };
-                    break;
-            }
+        template<typename T>
+        proxy_bool<not_cmp_expr<std::not_equal_to<>,T>> operator!=(T&& value) const {
+            return negate<std::not_equal_to<>>(std::forward<T>(value));
         }
 
-        proxy_bool(const PredFunctor<T> &_predFunc) : predFunc{_predFunc} {};
+        template<typename T>
+        proxy_bool<not_cmp_expr<std::less<>,T>> operator<(T&& value) const {
+            return negate<std::less<>>(std::forward<T>(value));
+        }
+
+        template<typename T>
+        proxy_bool<not_cmp_expr<std::greater<>,T>> operator>(T&& value) const {
+            return negate<std::greater<>>(std::forward<T>(value));
+        }
+
+        template<typename T>
+        proxy_bool<not_cmp_expr<std::less_equal<>,T>> operator<=(T&& value) const {
+            return negate<std::less_equal<>>(std::forward<T>(value));
+        }
+
+        template<typename T>
+        proxy_bool<not_cmp_expr<std::greater_equal<>,T>> operator>=(T&& value) const {
+            return negate<std::greater_equal<>>(std::forward<T>(value));
+        }
+};
+
+template<typename T>
+struct operand{
+    using type = value_expr<T>;
+    static constexpr bool is_expr = false;
+    static constexpr bool is_pred = false;
+
+    static type get(const T& value){
+        return type{value};
+    }
+};
+
+template<>
+struct operand<placeholder>{
+    using type = arg_expr;
+    static constexpr bool is_expr = true;
+    static constexpr bool is_pred = false;
+
+    static type get(const placeholder&){
+        return type{};
+    }
+};
+
+template<typename E>
+struct operand<proxy_trans<E>>{
+    using type = E;
+    static constexpr bool is_expr = true;
+    static constexpr bool is_pred = false;
+
+    static type get(const proxy_trans<E>& proxy){
+        return proxy.get_expr();
+    }
+};
+
+template<typename E>
+struct operand<proxy_bool<E>>{
+    using type = E;
+    static constexpr bool is_expr = false;
+    static constexpr bool is_pred = true;
+
+    static type get(const proxy_bool<E>& proxy){
+        return proxy.get_pred();
+    }
+};
+
+template<>
+struct operand<not_proxy_bool>{
+    using type = unary_expr<std::logical_not<>, arg_expr>;
+    static constexpr bool is_expr = false;
+    static constexpr bool is_pred = true;
 
-        template<typename TT>
-        proxy_bool operator&&(const proxy_bool<TT>& other){
-            return PredFunctor<T>{ [=](const auto& arg) { return predFunc(arg) && other.predFunc(arg); } };
-        }
+    static type get(const not_proxy_bool&){
+        return type{};
+    }
+};
 
-        template<typename TT>
-        proxy_bool operator||(const proxy_bool<TT>& other){
-            return PredFunctor<T>{ [=](const auto& arg) { return predFunc(arg) || other.predFunc(arg); } };
-        }
+template<typename T>
+using operand_t = typename operand<std::decay_t<const T>>::type;
 
-        proxy_bool operator!(){
-            return PredFunctor<T>{[=](const auto &arg) { return !predFunc(arg); }};
-        }
-};
+template<typename L, typename R>
+constexpr bool is_arith_operands_v = (operand<std::decay_t<const L>>::is_expr || operand<std::decay_t<const R>>::is_expr)
+                                     && !operand<std::decay_t<const L>>::is_pred && !operand<std::decay_t<const R>>::is_pred;
 
-class not_proxy_bool{
-    public:
-        not_proxy_bool() = default;
+template<typename T>
+constexpr bool is_logic_operand_v = operand<std::decay_t<const T>>::is_expr || operand<std::decay_t<const T>>::is_pred;
 
-        template<typename T>
-        proxy_bool<T> operator==(T&& value){
-            return proxy_bool<T>(bool_flag::equals, std::forward<T>(value), true);
-        }
+template<typename T>
+auto to_expr(const T& value){
+    return operand<std::decay_t<const T>>::get(value);
+}
 
-        template<typename T>
-        proxy_bool<T> operator!=(T&& value){
-            return proxy_bool<T>(bool_flag::nequals, std::forward<T>(value), true);
-        }
+#define ADD_LIST_COMP_EXPR_OPERATOR(Oper,Functor,Proxy)\
+template<typename L, typename R, typename=std::enable_if_t<is_arith_operands_v<L,R>>>\
+Proxy<binary_expr<Functor, operand_t<L>, operand_t<R>>> operator Oper(const L& lhs, const R& rhs){\
+    return binary_expr<Functor, operand_t<L>, operand_t<R>>{to_expr(lhs), to_expr(rhs)};\
+}\
 
-        template<typename T>
-        proxy_bool<T> operator<(T&& value){
-            return proxy_bool<T>(bool_flag::lthan, std::forward<T>(value), true);
-        }
+ADD_LIST_COMP_EXPR_OPERATOR(*, std::multiplies<>, proxy_trans);
+ADD_LIST_COMP_EXPR_OPERATOR(/, std::divides<>, proxy_trans);
+ADD_LIST_COMP_EXPR_OPERATOR(+, std::plus<>, proxy_trans);
+ADD_LIST_COMP_EXPR_OPERATOR(-, std::minus<>, proxy_trans);
+ADD_LIST_COMP_EXPR_OPERATOR(%, std::modulus<>, proxy_trans);
+
+ADD_LIST_COMP_EXPR_OPERATOR(==, std::equal_to<>, proxy_bool);
+ADD_LIST_COMP_EXPR_OPERATOR(!=, std::not_equal_to<>, proxy_bool);
+ADD_LIST_COMP_EXPR_OPERATOR(<, std::less<>, proxy_bool);
+ADD_LIST_COMP_EXPR_OPERATOR(>, std::greater<>, proxy_bool);
+ADD_LIST_COMP_EXPR_OPERATOR(<=, std::less_equal<>, proxy_bool);
+ADD_LIST_COMP_EXPR_OPERATOR(>=, std::greater_equal<>, proxy_bool);
+
+template<typename T, typename=std::enable_if_t<operand<std::decay_t<const T>>::is_expr>>
+proxy_trans<unary_expr<std::negate<>, operand_t<T>>> operator-(const T& value){
+    return unary_expr<std::negate<>, operand_t<T>>{to_expr(value)};
+}
 
-        template<typename T>
-        proxy_bool<T> operator>(T&& value){
-            return proxy_bool<T>(bool_flag::gthan, std::forward<T>(value), true);
+template<typename L, typename R, typename=std::enable_if_t<is_logic_operand_v<L> && is_logic_operand_v<R>>>
+proxy_bool<and_expr<operand_t<L>, operand_t<R>>> operator&&(const L& lhs, const R& rhs){
+    return and_expr<operand_t<L>, operand_t<R>>{to_expr(lhs), to_expr(rhs)};
+}
+
+template<typename L, typename R, typename=std::enable_if_t<is_logic_operand_v<L> && is_logic_operand_v<R>>>
+proxy_bool<or_expr<operand_t<L>, operand_t<R>>> operator||(const L& lhs, const R& rhs){
+    return or_expr<operand_t<L>, operand_t<R>>{to_expr(lhs), to_expr(rhs)};
+}
+
+template<typename E>
+proxy_bool<unary_expr<std::logical_not<>, E>> operator!(const proxy_bool<E>& proxy){
+    return unary_expr<std::logical_not<>, E>{proxy.get_pred()};
+}
+
+template<typename E>
+proxy_bool<unary_expr<std::logical_not<>, E>> operator!(const proxy_trans<E>& proxy){
+    return unary_expr<std::logical_not<>, E>{proxy.get_expr()};
+}
+
+template<typename InT, typename OutT, typename Iterator>
+class if_impl : public implicit_convertable<InT,OutT,Iterator>{
+    public:
+        using implicit_convertable<InT,OutT,Iterator>::implicit_convertable;
+
+        template<auto F>
+        else_impl<InT,OutT,Iterator> _else(trans<F>&&){
+            static_assert(is_cons_or_same_v<typename function_ptr<decltype(F)>::ReturnType,OutT>);
+            ElseFunctor<InT, OutT> elseFunctor = F;
+            return else_impl<InT, OutT, Iterator>(std::move(*this), std::move(elseFunctor),else_flag);
         }
 
-        template<typename T>
-        proxy_bool<T> operator<=(T&& value){
-            return proxy_bool<T>(bool_flag::gthaneq, std::forward<T>(value), true);
+        else_impl<InT,OutT,Iterator> _else(placeholder&){
+            ElseFunctor<InT,OutT> elseFunctor = [](const auto &arg) { return arg; };
+            return else_impl<InT,OutT,Iterator>(std::move(*this), std::move(elseFunctor),else_flag);
         }
 
-        template<typename T>
-        proxy_bool<T> operator>=(T&& value){
-            return proxy_bool<T>(bool_flag::lthaneq, std::forward<T>(value), true);
+        else_impl<InT,OutT,Iterator> _else(const OutT& val){
+            ElseFunctor<InT,OutT> elseFunctor = [val] (const auto&) { return val; };
+            return else_impl<InT,OutT,Iterator>(std::move(*this), std::move(elseFunctor),else_flag);
         }
 
-        template<typename T>
-        proxy_bool<T> operator&&(const proxy_bool<T>& other){
-            return proxy_bool<T>{[=](const auto &arg) { return !arg && other.get_pred()(arg); }};
+        template<typename E>
+        else_impl<InT,OutT,Iterator> _else(const proxy_trans<E>& proxy){
+            ElseFunctor<InT,OutT> elseFunctor = [expr = proxy.get_expr()](const InT& arg) { return static_cast<OutT>(expr(arg)); };
+            return else_impl<InT,OutT,Iterator>(std::move(*this), std::move(elseFunctor),else_flag);
         }
 
-        template<typename T>
-        proxy_bool<T> operator||(const proxy_bool<T>& other){
-            return proxy_bool<T>{[=](const auto &arg) { return !arg || other.get_pred()(arg); }};
+        else_impl<InT,OutT,Iterator> _else(ElseFunctor<InT,OutT> elseFunctor){
+            return else_impl<InT,OutT,Iterator>(std::move(*this), std::move(elseFunctor), else_flag);
         }
 };
 
@@ -513,23 +1498,32 @@ class in_impl : public implicit_convertable<InT,OutT,Iterator>{
     public:
         using implicit_convertable<InT,OutT,Iterator>::implicit_convertable;
 
+        template<typename Hash>
+        in_impl _memo(memo_cache<InT,OutT,Hash>& cache) const {
+            in_impl res(*this);
+            res.memoize(cache);
+            return res;
+        }
+
         if_impl<InT,OutT,Iterator> _if(placeholder&) {
             PredFunctor<InT> predFunctor = [] (const auto& val) ->bool { return val; };
             return if_impl<InT,OutT,Iterator>(std::move(*this), std::move(predFunctor),pred_flag);
         }
 
-        template<typename TT>
-        if_impl<InT,OutT,Iterator> _if(proxy_bool<TT> &&proxy){
-            PredFunctor<InT> pred = [&](auto arg) { return proxy.get_pred()(arg); };
+        template<typename E>
+        if_impl<InT,OutT,Iterator> _if(const proxy_bool<E>& proxy){
+            PredFunctor<InT> pred = [expr = proxy.get_pred()](const InT& arg) ->bool { return expr(arg); };
             return if_impl<InT,OutT,Iterator>(std::move(*this), std::move(pred),pred_flag);
         }
 
-        if_impl<InT,OutT,Iterator> _if(proxy_bool<InT> &&proxy){
-            return if_impl<InT,OutT,Iterator>(std::move(*this), proxy.get_pred(),pred_flag);
+        template<typename E>
+        if_impl<InT,OutT,Iterator> _if(const proxy_trans<E>& proxy){
+            PredFunctor<InT> pred = [expr = proxy.get_expr()](const InT& arg) ->bool { return expr(arg); };
+            return if_impl<InT,OutT,Iterator>(std::move(*this), std::move(pred),pred_flag);
         }
 
-        if_impl<InT,OutT,Iterator> _if(not_proxy_bool&&){
-            PredFunctor<InT> pred = [&](const auto &arg) ->bool { return !arg; };
+        if_impl<InT,OutT,Iterator> _if(const not_proxy_bool&){
+            PredFunctor<InT> pred = [](const auto &arg) ->bool { return !arg; };
             return if_impl<InT,OutT,Iterator>(std::move(*this), std::move(pred),pred_flag);
         }
 
@@ -567,6 +1561,22 @@ class for_impl{
             using Iterator = decltype(std::begin(array));
             return in_impl<T, OutT, Iterator>(std::begin(array), std::end(array), std::move(trans));
         }
+
+        template<typename... Iterators>
+        auto _in(const zip_range<Iterators...> &source){
+            using T = typename zip_range<Iterators...>::value_type;
+            using OutT = typename function_ptr<decltype(F)>::ReturnType;
+            TransFunctor<T, OutT> trans = F;
+            using Iterator = decltype(source.begin());
+            return in_impl<T, OutT, Iterator>(source.begin(), source.end(), std::move(trans));
+        }
+
+        template<typename T>
+        auto _in(){
+            using OutT = typename function_ptr<decltype(F)>::ReturnType;
+            TransFunctor<T, OutT> trans = F;
+            return in_impl<T, OutT, unbound_source>(unbound_source{}, unbound_source{}, std::move(trans));
+        }
 };
 
 template<>
@@ -593,6 +1603,66 @@ class for_impl<0>{
             using Iterator = decltype(std::begin(array));
             return in_impl<T, T, Iterator>(std::begin(array), std::end(array));
         }
+
+        template<typename... Iterators>
+        auto _in(const zip_range<Iterators...> &source){
+            using T = typename zip_range<Iterators...>::value_type;
+            using Iterator = decltype(source.begin());
+            return in_impl<T, T, Iterator>(source.begin(), source.end());
+        }
+
+        template<typename T>
+        auto _in(){
+            return in_impl<T, T, unbound_source>(unbound_source{}, unbound_source{});
+        }
+};
+
+template<typename E>
+class for_expr_impl{
+    private:
+        E expr;
+
+        template<typename T>
+        using OutT = std::decay_t<decltype(std::declval<const E&>()(std::declval<const T&>()))>;
+
+    public:
+        for_expr_impl(E _expr) : expr{std::move(_expr)} {};
+
+        template <template<typename> typename Cont, typename T>
+        auto _in(const Cont<T> &container){
+            static_assert(is_cont_v<Cont,T>, "argument to _in is not a container type");
+            TransFunctor<T, OutT<T>> trans = expr;
+            using Iterator = decltype(container.begin());
+            return in_impl<T, OutT<T>, Iterator>(container.begin(), container.end(), std::move(trans));
+        }
+
+        template <typename T>
+        auto _in(std::initializer_list<T> &&container){
+            TransFunctor<T, OutT<T>> trans = expr;
+            using Iterator = decltype(std::begin(container));
+            return in_impl<T, OutT<T>, Iterator>(std::begin(container), std::end(container), std::move(trans));
+        }
+
+        template<typename T, size_t Size>
+        auto _in(const T(&array)[Size]){
+            TransFunctor<T, OutT<T>> trans = expr;
+            using Iterator = decltype(std::begin(array));
+            return in_impl<T, OutT<T>, Iterator>(std::begin(array), std::end(array), std::move(trans));
+        }
+
+        template<typename... Iterators>
+        auto _in(const zip_range<Iterators...> &source){
+            using T = typename zip_range<Iterators...>::value_type;
+            TransFunctor<T, OutT<T>> trans = expr;
+            using Iterator = decltype(source.begin());
+            return in_impl<T, OutT<T>, Iterator>(source.begin(), source.end(), std::move(trans));
+        }
+
+        template<typename T>
+        auto _in(){
+            TransFunctor<T, OutT<T>> trans = expr;
+            return in_impl<T, OutT<T>, unbound_source>(unbound_source{}, unbound_source{}, std::move(trans));
+        }
 };
 
 template<typename T>
@@ -602,7 +1672,7 @@ struct range_iter : public std::iterator<std::forward_iterator_tag,T> {
 
     range_iter(T val, T j) : value{val}, jump{j} {};
 
-    T operator*() { return value; }
+    T operator*() const { return value; }
 
     range_iter &operator++() { 
         value+=jump;
@@ -639,26 +1709,8 @@ struct range_iter : public std::iterator<std::forward_iterator_tag,T> {
     }
 };
 
-#ifdef LISTCOMP_CONVERTABLES
-template<typename UT, template<typename...> typename... Ts>
-struct range_impl_oper : public range_impl_oper<UT,Ts>... {
-
-};
-
-template<typename UT, template<typename...> typename T>
-struct range_impl_oper<UT,T> {
-    virtual range_iter<UT> begin() const = 0;
-    virtual range_iter<UT> end() const = 0;
-
-    ADD_LIST_COMP_OPERATOR(T, UT);
-};
-
-template<typename T>
-struct _range : public range_impl_oper<T,LISTCOMP_CONVERTABLES> {
-#else
 template<typename T>
-struct _range {
-#endif
+struct _range : public convertable_t<_range<T>, T> {
     T limit;
     T init;
     T jump;
@@ -672,222 +1724,321 @@ struct _range {
     range_iter<T> end() const { return range_iter<T>{limit, jump}; }
     range_iter<T> begin() { return range_iter<T>{init, jump}; }
     range_iter<T> end() { return range_iter<T>{limit, jump}; }
+};
 
-    ADD_LIST_COMP_OPERATOR(std::vector, T);
+struct index_iter{
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::size_t;
 
-#ifndef LISTCOMP_DISABLE_STD_CONTAINERS
-    ADD_LIST_COMP_OPERATOR(std::deque, T);
-    ADD_LIST_COMP_OPERATOR(std::list, T);
-    ADD_LIST_COMP_OPERATOR(std::forward_list, T);
-#endif
-};
+    std::size_t index;
 
-} //namespace impl
+    std::size_t operator*() const { return index; }
 
-class placeholder{
+    index_iter &operator++() {
+        ++index;
+        return *this;
+    }
+
+    index_iter &operator--() {
+        --index;
+        return *this;
+    }
+
+    index_iter &operator+=(difference_type n) {
+        index += n;
+        return *this;
+    }
+
+    difference_type operator-(const index_iter& other) const {
+        return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+    }
+
+    bool operator==(const index_iter& other) const { return index == other.index; }
+    bool operator!=(const index_iter& other) const { return index != other.index; }
+};
+
+template<typename... Iterators>
+class zip_iter{
     private:
-        const int id;
+        std::tuple<Iterators...> iters;
 
-        inline static int inst_cnt = 0;
+        template<std::size_t... Is>
+        bool any_equal(const zip_iter& other, std::index_sequence<Is...>) const {
+            return ((std::get<Is>(iters) == std::get<Is>(other.iters)) || ...);
+        }
 
-        placeholder(int i) : id{i} { inst_cnt++; }
-        placeholder(placeholder&& other) : id{other.id} {};
+        template<std::size_t... Is>
+        auto deref(std::index_sequence<Is...>) const {
+            return value_type(*std::get<Is>(iters)...);
+        }
 
-        template <auto> friend class trans;
+        template<std::size_t... Is>
+        std::ptrdiff_t min_distance(const zip_iter& other, std::index_sequence<Is...>) const {
+            return std::min({static_cast<std::ptrdiff_t>(std::get<Is>(iters) - std::get<Is>(other.iters))...});
+        }
 
     public:
-        placeholder() : id{inst_cnt} { inst_cnt++; }
-        placeholder(placeholder &) : placeholder{} {};
-        placeholder &operator=(placeholder &) = delete;
-        placeholder &operator=(placeholder &&) = delete;
+        using iterator_category = std::common_type_t<std::random_access_iterator_tag, typename std::iterator_traits<Iterators>::iterator_category...>;
+        using value_type = std::tuple<decltype(*std::declval<const Iterators&>())...>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
 
-        const int get_id() const {
-            return id;
+        zip_iter(Iterators... _iters) : iters{_iters...} {};
+
+        value_type operator*() const {
+            return deref(std::index_sequence_for<Iterators...>{});
         }
 
-        placeholder operator,(const placeholder &other){
-            return std::move(placeholder{id+other.id});
+        zip_iter &operator++() {
+            std::apply([](auto&... it) { (++it, ...); }, iters);
+            return *this;
         }
 
-        impl::for_impl<0> _for(placeholder&){
-            return impl::for_impl<0>{};
+        zip_iter operator++(int) {
+            zip_iter res(*this);
+            ++(*this);
+            return res;
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator==(T&& value){
-            return impl::proxy_bool<T>(impl::bool_flag::equals, std::forward<T>(value));
+        zip_iter &operator--() {
+            std::apply([](auto&... it) { (--it, ...); }, iters);
+            return *this;
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator!=(T&& value){
-            return impl::proxy_bool<T>(impl::bool_flag::nequals, std::forward<T>(value));
+        zip_iter operator--(int) {
+            zip_iter res(*this);
+            --(*this);
+            return res;
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator<(T&& value){
-            return impl::proxy_bool<T>(impl::bool_flag::lthan, std::forward<T>(value));
+        zip_iter &operator+=(difference_type n) {
+            std::apply([n](auto&... it) { ((it += n), ...); }, iters);
+            return *this;
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator>(T&& value){
-            return impl::proxy_bool<T>(impl::bool_flag::gthan, std::forward<T>(value));
+        zip_iter &operator-=(difference_type n) {
+            return (*this) += -n;
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator<=(T&& value){
-            return impl::proxy_bool<T>(impl::bool_flag::lthaneq, std::forward<T>(value));
+        zip_iter operator+(difference_type n) const {
+            zip_iter res(*this);
+            return res += n;
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator>=(T&& value){
-            return impl::proxy_bool<T>(impl::bool_flag::gthaneq, std::forward<T>(value));
+        zip_iter operator-(difference_type n) const {
+            zip_iter res(*this);
+            return res -= n;
         }
 
-        template<typename T>
-        friend impl::proxy_bool<T> operator==(T&& value, placeholder&){
-            return impl::proxy_bool<T>(impl::bool_flag::requals, std::forward<T>(value));
+        difference_type operator-(const zip_iter& other) const {
+            return min_distance(other, std::index_sequence_for<Iterators...>{});
         }
 
-        template<typename T>
-        friend impl::proxy_bool<T> operator!=(T&& value, placeholder&){
-            return impl::proxy_bool<T>(impl::bool_flag::rnequals, std::forward<T>(value));
+        value_type operator[](difference_type n) const {
+            return *((*this) + n);
         }
 
-        template<typename T>
-        friend impl::proxy_bool<T> operator<(T&& value, placeholder&){
-            return impl::proxy_bool<T>(impl::bool_flag::rlthan, std::forward<T>(value));
+        bool operator==(const zip_iter& other) const {
+            return any_equal(other, std::index_sequence_for<Iterators...>{});
         }
 
-        template<typename T>
-        friend impl::proxy_bool<T> operator>(T&& value, placeholder&){
-            return impl::proxy_bool<T>(impl::bool_flag::rgthan, std::forward<T>(value));
+        bool operator!=(const zip_iter& other) const {
+            return !((*this) == other);
         }
 
-        template<typename T>
-        friend impl::proxy_bool<T> operator<=(T&& value, placeholder&){
-            return impl::proxy_bool<T>(impl::bool_flag::rlthaneq, std::forward<T>(value));
+        bool operator<(const zip_iter& other) const {
+            return (*this) - other < 0;
         }
 
-        template<typename T>
-        friend impl::proxy_bool<T> operator>=(T&& value, placeholder&){
-            return impl::proxy_bool<T>(impl::bool_flag::rgthaneq, std::forward<T>(value));
+        bool operator>(const zip_iter& other) const {
+            return other < (*this);
         }
 
-        impl::not_proxy_bool operator!(){
-            return impl::not_proxy_bool{};
+        bool operator<=(const zip_iter& other) const {
+            return !(other < (*this));
         }
 
-        template<template<typename> typename Cont, typename T>
-        impl::proxy_bool<T> _in(const Cont<T>& container){
-            static_assert(impl::is_cont_v<Cont, T>, "must be container type");
-            return impl::proxy_bool<T>{
-                [&](const auto &arg) {
-                    return std::find(container.begin(), container.end(), arg) != container.end();
-                }};
+        bool operator>=(const zip_iter& other) const {
+            return !((*this) < other);
         }
+};
 
-        template <typename T>
-        impl::proxy_bool<T> _in(const std::initializer_list<T> &container){
-            return impl::proxy_bool<T>{
-                [&](const auto &arg) {
-                    return std::find(std::begin(container), std::end(container), arg) != std::end(container);
-                }};
+template<typename... Iterators>
+class zip_range{
+    private:
+        zip_iter<Iterators...> first;
+        zip_iter<Iterators...> last;
+
+    public:
+        using value_type = typename zip_iter<Iterators...>::value_type;
+
+        zip_range(zip_iter<Iterators...> _first, zip_iter<Iterators...> _last) : first{_first}, last{_last} {};
+
+        zip_iter<Iterators...> begin() const { return first; }
+        zip_iter<Iterators...> end() const { return last; }
+};
+
+} //namespace impl
+
+class placeholder{
+    private:
+        const int id;
+
+        inline static std::atomic<int> inst_cnt{0};
+
+        placeholder(int i) : id{i} {};
+        placeholder(placeholder&& other) : id{other.id} {};
+
+        template <auto> friend class trans;
+
+        template<typename Iterator>
+        static impl::proxy_bool<impl::contains_expr<Iterator>> contains(Iterator first, Iterator last){
+            return impl::contains_expr<Iterator>{first, last};
         }
 
-        template<typename T, size_t Size>
-        impl::proxy_bool<T> _in(const T(&array)[Size]){
-            return impl::proxy_bool<T>{
-                [&](const auto &arg) {
-                    return std::find(std::begin(array), std::end(array), arg) != std::end(array);
-                }};
+        template<typename Iterator>
+        static impl::proxy_bool<impl::unary_expr<std::logical_not<>, impl::contains_expr<Iterator>>> not_contains(Iterator first, Iterator last){
+            return impl::unary_expr<std::logical_not<>, impl::contains_expr<Iterator>>{{first, last}};
+        }
+
+    public:
+        placeholder() : id{inst_cnt.fetch_add(1, std::memory_order_relaxed)} {};
+        placeholder(placeholder &) : placeholder{} {};
+        placeholder &operator=(placeholder &) = delete;
+        placeholder &operator=(placeholder &&) = delete;
+
+        const int get_id() const {
+            return id;
+        }
+
+        placeholder operator,(const placeholder &other){
+            return std::move(placeholder{id+other.id});
+        }
+
+        impl::for_impl<0> _for(placeholder&){
+            return impl::for_impl<0>{};
+        }
+
+        impl::not_proxy_bool operator!(){
+            return impl::not_proxy_bool{};
         }
 
         template<template<typename> typename Cont, typename T>
-        impl::proxy_bool<T> _not_in(const Cont<T>& container){
+        auto _in(const Cont<T>& container){
             static_assert(impl::is_cont_v<Cont, T>, "must be container type");
-            return impl::proxy_bool<T>{
-                [&](const auto &arg) {
-                    return std::find(container.begin(), container.end(), arg) == container.end();
-                }};
+            return contains(container.begin(), container.end());
+        }
+
+        template<template<typename> typename Cont, typename T>
+        impl::proxy_bool<impl::owned_contains_expr<Cont<T>>> _in(Cont<T>&& container){
+            static_assert(impl::is_cont_v<Cont, T>, "must be container type");
+            return impl::owned_contains_expr<Cont<T>>{std::move(container)};
         }
 
         template <typename T>
-        impl::proxy_bool<T> _not_in(const std::initializer_list<T> &container){
-            return impl::proxy_bool<T>{
-                [&](const auto &arg) {
-                    return std::find(std::begin(container), std::end(container), arg) == std::end(container);
-                }};
+        impl::proxy_bool<impl::list_contains_expr<T>> _in(const std::initializer_list<T> &container){
+            return impl::list_contains_expr<T>{container};
         }
 
         template<typename T, size_t Size>
-        impl::proxy_bool<T> _not_in(const T(&array)[Size]){
-            return impl::proxy_bool<T>{
-                [&](const auto &arg) {
-                    return std::find(std::begin(array), std::end(array), arg) == std::end(array);
-                }};
+        auto _in(const T(&array)[Size]){
+            return contains(std::begin(array), std::end(array));
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator&&(const impl::proxy_bool<T>& proxy){
-            return impl::proxy_bool<T>{[&](const auto &arg) { return arg && proxy.get_pred()(arg); }};
+        template<template<typename> typename Cont, typename T>
+        auto _not_in(const Cont<T>& container){
+            static_assert(impl::is_cont_v<Cont, T>, "must be container type");
+            return not_contains(container.begin(), container.end());
         }
 
-        template<typename T>
-        impl::proxy_bool<T> operator||(const impl::proxy_bool<T>& proxy){
-            return impl::proxy_bool<T>{[&](const auto &arg) { return arg || proxy.get_pred()(arg); }};
+        template<template<typename> typename Cont, typename T>
+        impl::proxy_bool<impl::unary_expr<std::logical_not<>, impl::owned_contains_expr<Cont<T>>>> _not_in(Cont<T>&& container){
+            static_assert(impl::is_cont_v<Cont, T>, "must be container type");
+            return impl::unary_expr<std::logical_not<>, impl::owned_contains_expr<Cont<T>>>{{std::move(container)}};
         }
 
-        template<typename T>
-        impl::proxy_trans<T> operator*(T&& value){
-            return impl::proxy_trans<T>(impl::oper_flag::mult, std::forward<T>(value));
+        template <typename T>
+        impl::proxy_bool<impl::unary_expr<std::logical_not<>, impl::list_contains_expr<T>>> _not_in(const std::initializer_list<T> &container){
+            return impl::unary_expr<std::logical_not<>, impl::list_contains_expr<T>>{{container}};
         }
 
-        template<typename T>
-        impl::proxy_trans<T> operator/(T&& value){
-            return impl::proxy_trans<T>(impl::oper_flag::div, std::forward<T>(value));
+        template<typename T, size_t Size>
+        auto _not_in(const T(&array)[Size]){
+            return not_contains(std::begin(array), std::end(array));
         }
+};
 
-        template<typename T>
-        impl::proxy_trans<T> operator+(T&& value){
-            return impl::proxy_trans<T>(impl::oper_flag::add, std::forward<T>(value));
-        }
-        
-        template<typename T>
-        impl::proxy_trans<T> operator-(T&& value){
-            return impl::proxy_trans<T>(impl::oper_flag::sub, std::forward<T>(value));
-        }
+using impl::operator*;
+using impl::operator/;
+using impl::operator+;
+using impl::operator-;
+using impl::operator%;
+using impl::operator==;
+using impl::operator!=;
+using impl::operator<;
+using impl::operator>;
+using impl::operator<=;
+using impl::operator>=;
+using impl::operator&&;
+using impl::operator||;
+
+inline placeholder _i, _j, _k;
+
+template<typename K, typename V, typename Hash>
+class memo_cache{
+    private:
+        std::vector<std::optional<std::pair<K,V>>> slots;
+        std::size_t mask;
+        std::size_t hitCount = 0;
+        std::size_t missCount = 0;
+        Hash hasher;
 
-        template<typename T>
-        impl::proxy_trans<T> operator%(T&& value){
-            return impl::proxy_trans<T>(impl::oper_flag::mod, std::forward<T>(value));
+        std::size_t index(const K& key) const {
+            const std::uint64_t mixed = static_cast<std::uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<std::size_t>(mixed >> 32) & mask;
         }
 
-        template<typename T>
-        friend impl::proxy_trans<T> operator*(T&& value, placeholder&){
-            return impl::proxy_trans<T>(impl::oper_flag::rmult, std::forward<T>(value));
+    public:
+        explicit memo_cache(std::size_t capacity = 1024, Hash _hasher = Hash{}) :
+            slots(impl::round_capacity(capacity)), mask{slots.size() - 1}, hasher{std::move(_hasher)} {};
+
+        template<typename F>
+        V lookup(const K& key, const F& compute){
+            auto &slot = slots[index(key)];
+            if(slot && slot->first == key){
+                ++hitCount;
+                return slot->second;
+            }
+            ++missCount;
+            V value = compute(key);
+            slot.emplace(key, value);
+            return value;
         }
 
-        template<typename T>
-        friend impl::proxy_trans<T> operator/(T&& value, placeholder&){
-            return impl::proxy_trans<T>(impl::oper_flag::rdiv, std::forward<T>(value));
+        std::size_t hits() const {
+            return hitCount;
         }
 
-        template<typename T>
-        friend impl::proxy_trans<T> operator+(T&& value, placeholder&){
-            return impl::proxy_trans<T>(impl::oper_flag::radd, std::forward<T>(value));
-        }
-        
-        template<typename T>
-        friend impl::proxy_trans<T> operator-(T&& value, placeholder&){
-            return impl::proxy_trans<T>(impl::oper_flag::rsub, std::forward<T>(value));
+        std::size_t misses() const {
+            return missCount;
         }
 
-        template<typename T>
-        friend impl::proxy_trans<T> operator%(T&& value, placeholder&){
-            return impl::proxy_trans<T>(impl::oper_flag::rmod, std::forward<T>(value));
+        std::size_t capacity() const {
+            return slots.size();
         }
 
-}_i,_j,_k;
+        void clear(){
+            for(auto &slot : slots){
+                slot.reset();
+            }
+            hitCount = 0;
+            missCount = 0;
+        }
+};
 
 template <auto F>
 class trans {
@@ -910,10 +2061,27 @@ class trans {
         }
 };
 
-template<auto P, typename T=typename impl::function_ptr<decltype(P)>::ArgType>
-impl::proxy_bool<T> pred(placeholder&){
-    return impl::proxy_bool<T>([&](const auto &arg) { return P(arg); });
+template<auto P>
+impl::proxy_bool<impl::call_expr<P, impl::arg_expr>> pred(placeholder&){
+    return impl::call_expr<P, impl::arg_expr>{};
+}
+
+#ifndef LISTCOMP_DISABLE_MATH
+template<typename T, typename=std::enable_if_t<impl::operand<std::decay_t<const T>>::is_expr>>
+impl::proxy_trans<impl::unary_expr<impl::abs_op, impl::operand_t<T>>> _abs(const T& value){
+    return impl::unary_expr<impl::abs_op, impl::operand_t<T>>{impl::to_expr(value)};
+}
+
+template<typename T, typename=std::enable_if_t<impl::operand<std::decay_t<const T>>::is_expr>>
+impl::proxy_trans<impl::unary_expr<impl::sqrt_op, impl::operand_t<T>>> _sqrt(const T& value){
+    return impl::unary_expr<impl::sqrt_op, impl::operand_t<T>>{impl::to_expr(value)};
+}
+
+template<typename L, typename R, typename=std::enable_if_t<impl::is_arith_operands_v<L,R>>>
+impl::proxy_trans<impl::binary_expr<impl::pow_op, impl::operand_t<L>, impl::operand_t<R>>> _pow(const L& base, const R& exponent){
+    return impl::binary_expr<impl::pow_op, impl::operand_t<L>, impl::operand_t<R>>{impl::to_expr(base), impl::to_expr(exponent)};
 }
+#endif
 
 template<typename T, typename=std::enable_if_t<std::is_arithmetic_v<T>>>
 impl::_range<T> _range(T start, T end, T jump=1){
@@ -925,6 +2093,25 @@ impl::_range<T> _range(T end){
     return impl::_range<T>{end};
 }
 
+template<typename... Conts>
+auto _zip(const Conts&... containers){
+    static_assert(sizeof...(Conts) >= 2, "_zip needs at least two sources");
+    using Zip = impl::zip_range<decltype(std::begin(containers))...>;
+    return Zip({std::begin(containers)...}, {std::end(containers)...});
+}
+
+template<typename Cont>
+auto _enumerate(const Cont& container){
+    using Zip = impl::zip_range<impl::index_iter, decltype(std::begin(container))>;
+    const std::size_t unbounded = std::numeric_limits<std::ptrdiff_t>::max();
+    return Zip({impl::index_iter{0}, std::begin(container)}, {impl::index_iter{unbounded}, std::end(container)});
+}
+
+template<std::size_t N, typename T, typename=std::enable_if_t<impl::operand<std::decay_t<const T>>::is_expr>>
+impl::proxy_trans<impl::get_expr<N, impl::operand_t<T>>> _get(const T& value){
+    return impl::get_expr<N, impl::operand_t<T>>{impl::to_expr(value)};
+}
+
 } //namespace pylistcomp
 
 #endif
@@ -0,0 +1,117 @@
+#include "../pylistcomp.h"
+
+#ifndef LISTCOMP_CORPUS_BARE
+
+#include<vector>
+#include<list>
+#include<deque>
+#include<string>
+#include<cstddef>
+
+namespace corpus{
+
+using namespace pylistcomp;
+
+int square(int x){
+    return x*x;
+}
+
+double half(int x){
+    return x / 2.0;
+}
+
+bool is_odd(const int& x){
+    return x % 2;
+}
+
+std::size_t length(std::string s){
+    return s.size();
+}
+
+std::vector<int> filtered(const std::vector<int>& data){
+    placeholder x;
+    return x._for(x)._in(data)._if(x>3 && x%2==0);
+}
+
+std::list<int> else_values(const std::vector<int>& data){
+    placeholder x;
+    return x._for(x)._in(data)._if(x<10)._else(-1);
+}
+
+std::deque<double> to_double(const std::list<int>& data){
+    placeholder x;
+    return trans<half>(x)._for(x)._in(data)._if(x!=0);
+}
+
+std::vector<int> squares(const std::deque<int>& data){
+    placeholder x;
+    return trans<square>(x)._for(x)._in(data)._if(pred<is_odd>(x));
+}
+
+std::vector<long> expressions(const std::vector<int>& data){
+    placeholder x;
+    return (x*x + 3)._for(x)._in(data)._if(_abs(x-5) > 2);
+}
+
+std::vector<std::size_t> lengths(const std::vector<std::string>& words){
+    placeholder w;
+    return trans<length>(w)._for(w)._in(words)._if(w!="");
+}
+
+std::vector<int> membership(const std::vector<int>& data, const std::vector<int>& blocked){
+    placeholder x;
+    return x._for(x)._in(data)._if(x._not_in(blocked));
+}
+
+std::vector<int> ranged(){
+    placeholder x;
+    return x._for(x)._in(_range(0, 100, 3))._if(x%7==0);
+}
+
+std::vector<int> planned(const std::vector<int>& first, const std::vector<int>& second){
+    placeholder x;
+    const auto plan = (x*2)._for(x)._in<int>()._if(x>0);
+    std::vector<int> res = plan(first);
+    std::vector<int> more = plan(second);
+    res.insert(res.end(), more.begin(), more.end());
+    return res;
+}
+
+std::vector<int> bounded(const std::vector<int>& data){
+    placeholder x;
+    std::vector<int> res = x._for(x)._in(data)._take_while(x>=0)._take(10);
+    std::vector<int> top = x._for(x)._in(data)._top_k(3);
+    res.insert(res.end(), top.begin(), top.end());
+    return res;
+}
+
+std::vector<double> zipped(const std::vector<int>& ids, const std::vector<double>& scores){
+    placeholder row;
+    return (_get<0>(row) * _get<1>(row))._for(row)._in(_zip(ids, scores))._if(_get<1>(row) > 0.5);
+}
+
+std::vector<int> memoized(const std::vector<int>& data, memo_cache<int,int>& cache){
+    placeholder x;
+    return trans<square>(x)._for(x)._in(data)._memo(cache);
+}
+
+std::vector<int> grouped(const std::vector<int>& data){
+    placeholder x;
+    auto [small, large] = x._for(x)._in(data)._if(x<50)._partition();
+    auto buckets = x._for(x)._in(data)._if(x>=0)._group_by(x%4, 4);
+    std::vector<int> res = small;
+    res.push_back(static_cast<int>(buckets[0].size()));
+    return res;
+}
+
+std::vector<int> sorted(const std::vector<int>& data){
+    placeholder x;
+    std::vector<int> res = x._for(x)._in(data)._sorted_distinct();
+    std::vector<int> seen = x._for(x)._in(data)._distinct();
+    res.insert(res.end(), seen.begin(), seen.end());
+    return res;
+}
+
+}
+
+#endif
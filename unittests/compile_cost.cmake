@@ -0,0 +1,52 @@
+cmake_minimum_required(VERSION 3.23)
+
+# Compiles SOURCE once per case and language standard and records wall time and object size.
+# The bare cases only include the header, once as is and once with every LISTCOMP_DISABLE_* macro.
+# Invoked by the compile_cost target with COMPILER, SOURCE, OUTPUT_DIR, BUDGET_MS and BUDGET_BYTES.
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+set(report ${OUTPUT_DIR}/compile_cost.csv)
+if(NOT EXISTS ${report})
+    file(WRITE ${report} "date,case,standard,milliseconds,bytes\n")
+endif()
+
+string(TIMESTAMP date "%Y-%m-%dT%H:%M:%S")
+set(failed FALSE)
+
+set(corpus_flags "")
+set(bare_flags -DLISTCOMP_CORPUS_BARE)
+set(bare_disabled_flags -DLISTCOMP_CORPUS_BARE -DLISTCOMP_DISABLE_STD_CONTAINERS -DLISTCOMP_DISABLE_PIPELINE
+                        -DLISTCOMP_DISABLE_GROUPING -DLISTCOMP_DISABLE_MATH)
+
+foreach(case corpus bare bare_disabled)
+    foreach(standard 17 20)
+        set(object ${OUTPUT_DIR}/compile_${case}_cxx${standard}.o)
+
+        string(TIMESTAMP started "%s%f")
+        execute_process(COMMAND ${COMPILER} -std=c++${standard} -O2 ${${case}_flags} -c ${SOURCE} -o ${object}
+                        RESULT_VARIABLE result ERROR_VARIABLE errors)
+        string(TIMESTAMP finished "%s%f")
+
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "compiling ${SOURCE} (${case}) as c++${standard} failed:\n${errors}")
+        endif()
+
+        math(EXPR milliseconds "(${finished} - ${started}) / 1000")
+        file(SIZE ${object} bytes)
+        file(APPEND ${report} "${date},${case},c++${standard},${milliseconds},${bytes}\n")
+        message(STATUS "${case} c++${standard}: ${milliseconds} ms, ${bytes} bytes")
+
+        if(BUDGET_MS GREATER 0 AND milliseconds GREATER BUDGET_MS)
+            message(SEND_ERROR "${case} c++${standard}: compile time ${milliseconds} ms exceeds budget of ${BUDGET_MS} ms")
+            set(failed TRUE)
+        endif()
+        if(BUDGET_BYTES GREATER 0 AND bytes GREATER BUDGET_BYTES)
+            message(SEND_ERROR "${case} c++${standard}: object size ${bytes} bytes exceeds budget of ${BUDGET_BYTES} bytes")
+            set(failed TRUE)
+        endif()
+    endforeach()
+endforeach()
+
+if(failed)
+    message(FATAL_ERROR "compile cost budget exceeded, see ${report}")
+endif()
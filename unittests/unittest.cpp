@@ -1,6 +1,530 @@
+#include<vector>
+#include<list>
+#include<memory>
+#include<optional>
+
+template<typename T>
+struct flat_bag{
+    std::vector<T> items;
+
+    template<typename Iterator>
+    flat_bag(Iterator first, Iterator last) : items(first, last) {};
+};
+
+template<typename T, typename Alloc = std::allocator<T>>
+struct linked_bag{
+    std::list<T, Alloc> items;
+
+    template<typename Iterator>
+    linked_bag(Iterator first, Iterator last) : items(first, last) {};
+};
+
+#define LISTCOMP_CONVERTABLES flat_bag,linked_bag
 #include "../pylistcomp.h"
 
-int main(){
+#if __cplusplus >= 202002L && !defined(LISTCOMP_USE_CONCEPTS)
+#error "C++20 builds are expected to use the concepts-based conversions"
+#endif
+
+#include<thread>
+#include<atomic>
+#include<set>
+#include<string>
+#include<mutex>
+#include<stdexcept>
+#include<iterator>
+#include<cstddef>
+#include<algorithm>
+#include<random>
+#include<cstdint>
+
+namespace{
+
+int square(int x){
+    return x*x;
+}
+
+bool reject_13(const int& x){
+    if(x == 13){
+        throw std::runtime_error("filter");
+    }
+    return x % 2 == 0;
+}
+
+int reject_99(int x){
+    if(x == 99){
+        throw std::runtime_error("consumer");
+    }
+    return x + 1;
+}
+
+template<typename T>
+struct flaky_source{
+    struct iter{
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const flaky_source *source;
+        std::size_t pos;
+
+        const T &operator*() const {
+            if(pos == source->fail_at){
+                throw std::runtime_error("reader");
+            }
+            return source->values[pos];
+        }
+
+        iter &operator++(){
+            ++pos;
+            return *this;
+        }
+
+        iter operator++(int){
+            iter res(*this);
+            ++pos;
+            return res;
+        }
+
+        bool operator==(const iter& other) const {
+            return pos == other.pos;
+        }
+
+        bool operator!=(const iter& other) const {
+            return pos != other.pos;
+        }
+    };
+
+    std::vector<T> values;
+    std::size_t fail_at;
+
+    iter begin() const {
+        return iter{this, 0};
+    }
+
+    iter end() const {
+        return iter{this, values.size()};
+    }
+};
+
+template<typename F>
+bool throws_runtime_error(const F& f, const char *what){
+    try{
+        f();
+    }
+    catch(const std::runtime_error& e){
+        return std::string(e.what()) == what;
+    }
+    return false;
+}
+
+bool placeholder_expressions(){
+    using namespace pylistcomp;
+
+    std::vector<int> v{5,1,9,3,7,2,8};
+    const double mean = 5.0, sd = 2.0;
+
+    placeholder i;
+    std::vector<int> shifted = (i*i + 3)._for(i)._in(v);
+    std::vector<double> scores = ((i - mean)/sd)._for(i)._in(v)._if(i>6);
+    std::vector<double> halves = (i*0.5)._for(i)._in(v)._if(i%2==1);
+    std::vector<int> distances = _abs(i - 5)._for(i)._in(v);
+    std::vector<double> roots = _sqrt(i)._for(i)._in(v)._if(i==9 || i==1);
+    std::vector<double> powers = _pow(i, 2)._for(i)._in(v)._if(i<3);
+    std::vector<int> mirrored = i._for(i)._in(v)._if(i>4)._else(i*-1);
+    std::vector<int> combined = i._for(i)._in(v)._if((i>2 && i<8) || i==9);
+    std::vector<int> negated = i._for(i)._in(v)._if(!(i>2 && i<8));
+
+    return shifted == std::vector<int>{28,4,84,12,52,7,67} &&
+           scores == std::vector<double>{2.0,1.0,1.5} &&
+           halves == std::vector<double>{2.5,0.5,4.5,1.5,3.5} &&
+           distances == std::vector<int>{0,4,4,2,2,3,3} &&
+           roots == std::vector<double>{1.0,3.0} &&
+           powers == std::vector<double>{1.0,4.0} &&
+           mirrored == std::vector<int>{5,-1,9,-3,7,-2,8} &&
+           combined == std::vector<int>{5,9,3,7} &&
+           negated == std::vector<int>{1,9,2,8};
+}
+
+bool negated_placeholder_comparisons(){
+    using namespace pylistcomp;
+
+    std::vector<int> v{5,1,9,3,7,2,8};
+
+    placeholder i;
+    std::vector<int> notEqual = i._for(i)._in(v)._if(!i == 5);
+    std::vector<int> notUnequal = i._for(i)._in(v)._if(!i != 5);
+    std::vector<int> notLess = i._for(i)._in(v)._if(!i < 5);
+    std::vector<int> notGreater = i._for(i)._in(v)._if(!i > 5);
+    std::vector<int> notAtMost = i._for(i)._in(v)._if(!i <= 5);
+    std::vector<int> notAtLeast = i._for(i)._in(v)._if(!i >= 5);
+
+    return notEqual == std::vector<int>{1,9,3,7,2,8} && notUnequal == std::vector<int>{5} &&
+           notLess == std::vector<int>{5,9,7,8} && notGreater == std::vector<int>{5,1,3,2} &&
+           notAtMost == std::vector<int>{9,7,8} && notAtLeast == std::vector<int>{1,3,2};
+}
+
+bool early_termination(){
+    using namespace pylistcomp;
+
+    std::vector<int> v{5,1,9,3,7,2,8};
+    std::vector<int> none;
+
+    placeholder i;
+    std::vector<int> stopFirst = i._for(i)._in(v)._take_while(i!=9)._take_while(i<100);
+    std::vector<int> stopLast = i._for(i)._in(v)._take_while(i<100)._take_while(i!=9);
+    std::vector<int> bothStops = i._for(i)._in(v)._take_while(i!=3)._take_while(i!=9);
+
+    std::optional<int> first = (i*10)._for(i)._in(v)._if(i>6)._first();
+    std::optional<int> missing = i._for(i)._in(none)._first();
+
+    std::vector<int> highest = i._for(i)._in(v)._top_k(3);
+    std::vector<int> lowest = i._for(i)._in(v)._if(i!=1)._top_k(3, std::greater<>{});
+    std::vector<int> all = i._for(i)._in(v)._top_k(20);
+    std::vector<int> zero = i._for(i)._in(v)._top_k(0);
+
+    return stopFirst == std::vector<int>{5,1} && stopLast == stopFirst && bothStops == stopFirst &&
+           first == 90 && !missing &&
+           highest == std::vector<int>{9,8,7} && lowest == std::vector<int>{2,3,5} &&
+           all == std::vector<int>{9,8,7,5,3,2,1} && zero.empty();
+}
+
+bool custom_convertables(){
+    using namespace pylistcomp;
+
+    std::vector<int> v{5,1,9,3,7,2,8};
+
+    placeholder i;
+    auto comp = i._for(i)._in(v)._if(i>4);
+    static_assert(!std::is_polymorphic_v<decltype(comp)>);
+    static_assert(!std::is_polymorphic_v<decltype(_range(3))>);
+
+    flat_bag<int> fromComprehension = comp;
+    linked_bag<long> widened = comp;
+    flat_bag<int> fromRange = _range(3);
+    linked_bag<int> fromBuffer = i._for(i)._in(v)._top_k(2);
+
+    return fromComprehension.items == std::vector<int>{5,9,7,8} &&
+           widened.items == std::list<long>{5,9,7,8} &&
+           fromRange.items == std::vector<int>{0,1,2} &&
+           fromBuffer.items == std::list<int>{9,8};
+}
+
+bool plans_bound_to_sources(){
+    using namespace pylistcomp;
+
+    std::vector<int> v{5,1,9,3,7,2,8};
+    std::list<int> l{4,6};
+    const int array[]{10,1};
+
+    placeholder i;
+    const auto plan = (i*2)._for(i)._in<int>()._if(i>1);
+    std::vector<int> fromVector = plan(v);
+    std::vector<int> fromList = plan(l);
+    std::vector<int> fromArray = plan(array);
+    std::vector<int> fromBraces = plan({0,3});
+    std::vector<int> limited = plan._take(2)(v);
+
+    auto bound = (i*2)._for(i)._in<int>()._if(i>1)(v);
+    std::vector<int> fromTemporaryPlan = bound;
+
+    return fromVector == std::vector<int>{10,18,6,14,4,16} && fromList == std::vector<int>{8,12} &&
+           fromArray == std::vector<int>{20} && fromBraces == std::vector<int>{6} &&
+           limited == std::vector<int>{10,18} && fromTemporaryPlan == fromVector;
+}
+
+auto stored_query(const std::vector<int>& data){
+    using namespace pylistcomp;
+
+    placeholder i;
+    return i._for(i)._in(data)._if(i._in(std::vector<int>{2,3,9}) || i._not_in(std::list<int>{1,2,3,5,9}))._else(0);
+}
+
+bool stored_membership_queries(){
+    std::vector<int> v{5,1,9,3,7,2,8};
+    auto query = stored_query(v);
+    auto copy = query;
+    std::vector<int> first = query;
+    std::vector<int> second = copy;
+    return first == std::vector<int>{0,0,9,3,7,2,8} && second == first;
+}
 
+template<typename Comp>
+bool terminals_match_conversion(Comp comp, const std::vector<int>& expectedRest){
+    using namespace pylistcomp;
+
+    placeholder i;
+    std::vector<int> converted = comp;
+    std::vector<int> piped = comp._pipelined(4);
+    auto [matching, rest] = comp._partition();
+    std::vector<int> partitioned = matching;
+    std::vector<int> rejected = rest;
+    auto groups = comp._group_by(i%2);
+    std::vector<int> grouped = groups[0];
+    grouped.insert(grouped.end(), groups[1].begin(), groups[1].end());
+    std::sort(grouped.begin(), grouped.end());
+    std::vector<int> sorted = converted;
+    std::sort(sorted.begin(), sorted.end());
+
+    return piped == converted && partitioned == converted && rejected == expectedRest && grouped == sorted;
+}
+
+bool partition_and_group_by(){
+    using namespace pylistcomp;
+
+    placeholder i;
+    std::vector<int> v{5,-7,8,-3,-9,2,4};
+    const auto base = i._for(i)._in(v)._if(i>0);
+    return terminals_match_conversion(base._take_while(i>-5), {-7,-3,-9}) &&
+           terminals_match_conversion(base._take_while(i!=8), {-7}) &&
+           terminals_match_conversion(base._take(2), {-7}) &&
+           terminals_match_conversion(base._take(3)._take_while(i!=4), {-7,-3,-9}) &&
+           terminals_match_conversion(base, {-7,-3,-9});
+}
+
+template<typename T>
+bool sorted_matches_std(std::size_t size, std::mt19937_64& rng){
+    using namespace pylistcomp;
+
+    std::vector<T> values;
+    for(std::size_t n=0; n<size; n++){
+        const std::uint64_t bits = rng();
+        if constexpr(std::is_floating_point_v<T>){
+            values.push_back(static_cast<T>(static_cast<std::int64_t>(bits % 2001) - 1000) / 8);
+        }
+        else{
+            values.push_back(static_cast<T>(n % 5 == 0 ? bits % 7 : bits));
+        }
+    }
+
+    placeholder x;
+    std::vector<T> sorted = x._for(x)._in(values)._sorted();
+    std::vector<T> distinct = x._for(x)._in(values)._sorted_distinct();
+
+    std::vector<T> expected = values;
+    std::sort(expected.begin(), expected.end());
+    if(sorted != expected){
+        return false;
+    }
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    return distinct == expected;
+}
+
+bool radix_sorted_outputs(){
+    std::mt19937_64 rng(2024);
+    for(std::size_t size : {0, 1, 10, 63, 64, 65, 1000, 20000}){
+        const bool ok = sorted_matches_std<std::int8_t>(size, rng) && sorted_matches_std<std::uint8_t>(size, rng) &&
+                        sorted_matches_std<short>(size, rng) && sorted_matches_std<int>(size, rng) &&
+                        sorted_matches_std<unsigned>(size, rng) && sorted_matches_std<std::int64_t>(size, rng) &&
+                        sorted_matches_std<std::uint64_t>(size, rng) && sorted_matches_std<float>(size, rng) &&
+                        sorted_matches_std<double>(size, rng);
+        if(!ok){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool distinct_and_custom_order(){
+    using namespace pylistcomp;
+
+    std::vector<int> v{5,1,5,9,1,3,9,7};
+    std::vector<std::string> words{"b","a","b","c","a"};
+
+    placeholder i, w;
+    std::vector<int> distinct = i._for(i)._in(v)._distinct();
+    std::vector<std::string> distinctWords = w._for(w)._in(words)._distinct();
+    std::vector<int> descending = (i*2)._for(i)._in(v)._if(i>1)._sorted(std::greater<>{});
+
+    return distinct == std::vector<int>{5,1,9,3,7} &&
+           distinctWords == std::vector<std::string>{"b","a","c"} &&
+           descending == std::vector<int>{18,18,14,10,10,6};
+}
+
+struct length_hash{
+    std::size_t operator()(const std::string& s) const {
+        return s.size();
+    }
+};
+
+std::size_t length_of(std::string s){
+    return s.size();
+}
+
+bool memoized_with_custom_hash(){
+    using namespace pylistcomp;
+
+    std::vector<std::string> words{"aa","b","aa","ccc","b","aa"};
+    memo_cache<std::string, std::size_t, length_hash> cache(16);
+
+    placeholder w;
+    std::vector<std::size_t> lengths = trans<length_of>(w)._for(w)._in(words)._memo(cache);
+    return lengths == std::vector<std::size_t>{2,1,2,3,1,2} && cache.misses() == 3 && cache.hits() == 3;
+}
+
+template<std::size_t Size>
+struct counted_adder{
+    int *live;
+    int payload[Size];
+
+    counted_adder(int *_live, int amount) : live{_live}, payload{amount} {
+        ++*live;
+    }
+
+    counted_adder(const counted_adder& other) : live{other.live} {
+        std::copy(std::begin(other.payload), std::end(other.payload), payload);
+        ++*live;
+    }
+
+    counted_adder(counted_adder&& other) noexcept : counted_adder(other) {};
+
+    ~counted_adder(){
+        --*live;
+    }
+
+    int operator()(int x) const {
+        return x + payload[0];
+    }
+};
+
+template<std::size_t Size>
+bool small_function_ownership(){
+    using function = pylistcomp::impl::small_function<int(int)>;
+
+    int live = 0;
+    bool ok = true;
+    {
+        function f = counted_adder<Size>(&live, 5);
+        function copied(f);
+        function moved(std::move(copied));
+        function assigned;
+        assigned = f;
+        function moveAssigned = nullptr;
+        moveAssigned = std::move(assigned);
+
+        ok = f(1) == 6 && moved(2) == 7 && moveAssigned(3) == 8 && live == 3;
+        ok = ok && !copied && !assigned;
+
+        f = f;
+        moved.reset();
+        ok = ok && f(0) == 5 && !moved && live == 2;
+    }
+    int (*empty)(int) = nullptr;
+    return ok && live == 0 && !function(empty);
+}
+
+bool zipped_sources(){
+    using namespace pylistcomp;
+
+    std::vector<int> ids{1,2,3,4,5};
+    std::list<double> scores{0.5,1.5,2.5};
+    std::vector<std::string> names{"a","","c","d"};
+
+    placeholder row;
+    std::vector<double> shortFirst = (_get<0>(row) * _get<1>(row))._for(row)._in(_zip(scores, ids));
+    std::vector<double> shortLast = (_get<0>(row) * _get<1>(row))._for(row)._in(_zip(ids, scores));
+    std::vector<int> threeWay = _get<0>(row)._for(row)._in(_zip(ids, names, ids))._if(_get<1>(row) != "");
+    std::vector<std::size_t> indexes = _get<0>(row)._for(row)._in(_enumerate(names))._if(_get<1>(row) != "");
+
+    auto zipped = _zip(ids, names);
+    const std::ptrdiff_t length = zipped.end() - zipped.begin();
+
+    return shortFirst == std::vector<double>{0.5,3.0,7.5} && shortLast == shortFirst &&
+           threeWay == std::vector<int>{1,3,4} && indexes == std::vector<std::size_t>{0,2,3} && length == 4;
+}
+
+bool pipeline_stages(){
+    using namespace pylistcomp;
+
+    std::vector<int> data;
+    for(int n=0; n<20000; n++){
+        data.push_back(n);
+    }
+
+    placeholder x;
+    std::vector<int> expected = (x*3)._for(x)._in(data)._if(x%7!=0)._else(-1);
+    std::vector<int> piped = (x*3)._for(x)._in(data)._if(x%7!=0)._else(-1)._pipelined(8);
+    if(piped != expected){
+        return false;
+    }
+
+    std::vector<int> taken = x._for(x)._in(data)._if(x%3==0)._take(5)._pipelined(4);
+    std::vector<int> prefix = x._for(x)._in(data)._take_while(x<100)._pipelined(4);
+    if(taken != std::vector<int>{0,3,6,9,12} || prefix.size() != 100 || prefix.back() != 99){
+        return false;
+    }
+
+    flaky_source<int> flaky{data, 5000};
+    bool ok = throws_runtime_error([&] { std::vector<int> res = x._for(x)._in(flaky)._pipelined(16); }, "reader");
+    ok = ok && throws_runtime_error([&] { std::vector<int> res = x._for(x)._in(data)._if(pred<reject_13>(x))._pipelined(16); }, "filter");
+    ok = ok && throws_runtime_error([&] { std::vector<int> res = trans<reject_99>(x)._for(x)._in(data)._pipelined(16); }, "consumer");
+    return ok;
+}
+
+bool concurrent_comprehensions(){
+    using namespace pylistcomp;
+
+    constexpr int threadCount = 16;
+    constexpr int iterations = 500;
+
+    std::vector<int> data;
+    for(int n=0; n<64; n++){
+        data.push_back(n);
+    }
+
+    std::atomic<bool> ok{true};
+    std::mutex idsLock;
+    std::set<int> ids;
+    std::vector<std::thread> workers;
+
+    for(int t=0; t<threadCount; t++){
+        workers.emplace_back([&, t] {
+            std::vector<int> localIds;
+            for(int n=0; n<iterations; n++){
+                placeholder x;
+                localIds.push_back(x.get_id());
+
+                std::vector<int> above = x._for(x)._in(data)._if(x>t);
+                std::vector<int> squares = trans<square>(_i)._for(_i)._in(data)._if(_i<8);
+                std::vector<int> shared = _j._for(_j)._in(data)._if(_j>=32)._else(0);
+
+                if(above.size() != data.size() - t - 1 || squares.size() != 8 || squares[7] != 49 ||
+                   shared.size() != data.size() || shared[31] != 0 || shared[32] != 32){
+                    ok = false;
+                }
+            }
+            std::lock_guard<std::mutex> lock(idsLock);
+            ids.insert(localIds.begin(), localIds.end());
+        });
+    }
+    for(auto &worker : workers){
+        worker.join();
+    }
+    return ok && ids.size() == threadCount * iterations;
+}
+
+}
+
+int main(){
+    if(!concurrent_comprehensions() || !pipeline_stages()){
+        return 1;
+    }
+    if(!placeholder_expressions() || !negated_placeholder_comparisons() || !stored_membership_queries()){
+        return 1;
+    }
+    if(!plans_bound_to_sources() || !custom_convertables() || !early_termination()){
+        return 1;
+    }
+    if(!small_function_ownership<1>() || !small_function_ownership<32>() || !zipped_sources()){
+        return 1;
+    }
+    if(!memoized_with_custom_hash() || !partition_and_group_by() || !radix_sorted_outputs()){
+        return 1;
+    }
+    if(!distinct_and_custom_order()){
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}